@@ -66,63 +66,11 @@ Layer layer0 = {
   &layer1,
 };
 
-/** Moving Layer
-*  Linked list of layer references
-*  Velocity represents one iteration of change (direction & magnitude)
-*/
-typedef struct MovLayer_s {
-  Layer *layer;
-  Vec2 velocity;
-  struct MovLayer_s *next;
-} MovLayer;
-
 /* initial value of {0,0} will be overwritten */
 MovLayer ml2 = { &layer2, {1,3}, 0 }; /**< not all layers move */
 MovLayer ml1 = { &layer1, {0,0}, &ml2 }; 
 MovLayer ml0 = { &layer0, {0,0}, &ml1 }; 
 
-//Just draws anything aorund a moving layer 
-void movLayerDraw(MovLayer *movLayers, Layer *layers)
-{
-  int row, col;
-  MovLayer *movLayer;
-
-  drawString5x7(20,0, "Welcome to Pong!", COLOR_GREEN, COLOR_BLACK);
-  drawString5x7(25,151, ":P1 Score P2:", COLOR_GREEN, COLOR_BLACK);
-  
-  and_sr(~8);			/**< disable interrupts (GIE off) */ //Turn off all interrupts 
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Layer *l = movLayer->layer;
-    l->posLast = l->pos;
-    l->pos = l->posNext;
-  }
-  or_sr(8);			/**< disable interrupts (GIE on) */ //Turn on all interupts
-
-
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Region bounds;
-    layerGetBounds(movLayer->layer, &bounds); 
-    lcd_setArea(bounds.topLeft.axes[0], bounds.topLeft.axes[1], 
-    bounds.botRight.axes[0], bounds.botRight.axes[1]);
-  //For every pixel in the area..
-    for (row = bounds.topLeft.axes[1]; row <= bounds.botRight.axes[1]; row++) {
-      for (col = bounds.topLeft.axes[0]; col <= bounds.botRight.axes[0]; col++) {
-  Vec2 pixelPos = {col, row};
-  u_int color = bgColor;
-  Layer *probeLayer; //We probe to get the colors..
-  for (probeLayer = layers; probeLayer; 
-      probeLayer = probeLayer->next) { /* probe all layers, in order */
-    if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-      color = probeLayer->color;
-      break; 
-    } /* if probe check */
-  } // for checking all layers at col, row
-  lcd_writeColor(color); 
-      } // for col
-    } // for row
-  } // for moving layer being updated
-}	  
-
 Region fence = {{10,10}, {SHORT_EDGE_PIXELS-10, LONG_EDGE_PIXELS-10}}; /**< Create a fence region */
 
 /** Advances a moving shape within a fence
@@ -137,7 +85,7 @@ Region fence = {{10,10}, {SHORT_EDGE_PIXELS-10, LONG_EDGE_PIXELS-10}}; /**< Crea
 *   a sound needs to be played. This code was made possible with the help of Miguel Nunez, Robert Facio, 
 *   and Brian Riveron. 
 */
-void mlAdvance(MovLayer *whitePaddle, MovLayer *redPaddle, MovLayer *ml, Region *fence)
+void pongAdvance(MovLayer *whitePaddle, MovLayer *redPaddle, MovLayer *ml, Region *fence)
 {
   //The vectors of the elements of the game..
   Vec2 newPos;
@@ -211,7 +159,6 @@ void mlAdvance(MovLayer *whitePaddle, MovLayer *redPaddle, MovLayer *ml, Region
             ml->layer->posNext = newPos;
             redScore++;
             //drawString5x7(70, 70, "ERROR 4!", COLOR_GREEN, COLOR_BLACK);
-            int redrawScreen = 1;
             break;
           }
           
@@ -224,12 +171,10 @@ void mlAdvance(MovLayer *whitePaddle, MovLayer *redPaddle, MovLayer *ml, Region
             ml->layer->posNext = newPos;
             whiteScore++;
             //drawString5x7(60,60, "ERROR 5!", COLOR_GREEN, COLOR_BLACK);
-            int redrawScreen = 1;
             break;
           }
         
         }/**< for axis */
-        int redrawScreen = 1;
         ml->layer->posNext = newPos;
         if(redScore > 9 || whiteScore > 9)
         {
@@ -242,10 +187,7 @@ void mlAdvance(MovLayer *whitePaddle, MovLayer *redPaddle, MovLayer *ml, Region
         
 
   }/**< for ml */
-   int redrawScreen = 1;
-  drawString5x7(3, 151, printRed, COLOR_RED, COLOR_BLACK);
-  drawString5x7(120, 151, printWhite, COLOR_WHITE, COLOR_BLACK);
- 
+  mlPublish();                 /**< hand the new positions to movLayerDraw */
 }
 
 //Track the buttons of player 1 and set the velocity of the moving paddle.
@@ -283,16 +225,126 @@ void p2(u_int button)
 }
 
 u_int bgColor = COLOR_BLACK;     /**< The background color */
-int redrawScreen = 1;           /**< Boolean for whether screen needs to be redrawn */
 
 Region fieldFence;		/**< fence around playing field  */
 Region fieldPaddleRed;
 Region fieldPaddleWhite;
 Region fieldBall;
 
+#define PONG_PERIOD TIMEBASE_MS(60) /**< time between moves of the ball */
+#define POLL_DELAY TIMEBASE_MS(25)  /**< recheck the switches after the debounce */
+#define TONE_LENGTH TIMEBASE_MS(120) /**< how long a point's tone sounds */
+#define TONE_PERIOD 2000	    /**< its period (buzzer timer ticks) */
+
+/** Clock for switch events: 4.1ms units (8192 timebase ticks) */
+u_int pongTicks() { return timebaseNow() >> 13; }
+
+void moveStep(Task *task);
+void paddleTaskStep(Task *task);
+void drawStep(Task *task);
+void toneOffStep(Task *task);
+
+Task moveTask = { moveStep, 1 };	/**< moves the ball */
+Task paddleTask = { paddleTaskStep, 1 }; /**< steers the paddles */
+Task drawTask = { drawStep, 2 };	/**< redraws what moved */
+Task toneOffTask = { toneOffStep, 3 };	/**< ends a point's tone */
+SoftTimer moveTimer = { {0}, &moveTask };
+SoftTimer toneTimer = { {0}, &toneOffTask };
+
+/** Alarm handler: rechecks the switches once a change's debounce window
+ *  has passed (pongSwitches re-arms it if there's another change)
+ *  \return nonzero (wake main) when the switch handler asks to
+ */
+int pollHandler(Alarm *alarm)
+{
+  return p2sw_poll();
+}
+
+Alarm pollAlarm = { 0, pollHandler }; /**< catches changes that ended in a bounce */
+
+/** Moves a paddle one step right away, unless that would leave the field */
+static void paddleStep(MovLayer *paddle)
+{
+  Vec2 newPos;
+  Region bounds;
+  vec2Add(&newPos, &paddle->layer->posNext, &paddle->velocity);
+  abShapeGetBounds(paddle->layer->abShape, &newPos, &bounds);
+  if (bounds.topLeft.axes[1] >= fieldFence.topLeft.axes[1] &&
+      bounds.botRight.axes[1] <= fieldFence.botRight.axes[1])
+    paddle->layer->posNext = newPos;
+}
+
+static volatile u_char switchState = 0xff;  /**< last switch state (bit clear = down) */
+static volatile u_char switchChanged;       /**< switches changed since paddleTask ran */
+
+/** Switch handler (runs in the PORT2 interrupt): records the change
+ *  and leaves steering to paddleTask
+ */
+int pongSwitches(const P2swEvent *event)
+{
+  alarmSet(&pollAlarm, timebaseNow() + POLL_DELAY); /**< once bounces settle */
+  switchState = event->state;
+  switchChanged |= event->changed;
+  return taskPost(&paddleTask); /**< wake main to run it */
+}
+
+/** Task: steers the paddles, and moves the one whose buttons changed
+ *  without waiting for the next move
+ */
+void paddleTaskStep(Task *task)
+{
+  u_char state, changed;
+  CRIT_ENTER();
+  state = switchState;
+  changed = switchChanged;
+  switchChanged = 0;
+  CRIT_EXIT();
+  P1OUT |= GREEN_LED;		/**< Green LED on when cpu on */
+  p1(state);
+  p2(state);
+  if (changed & (BIT0 | BIT1))
+    paddleStep(&ml1);
+  if (changed & (BIT2 | BIT3))
+    paddleStep(&ml0);
+  mlPublish();
+  taskPost(&drawTask);          /**< movLayerDraw redraws just what moved */
+}
 
-/** Initializes everything, enables interrupts and green LED, 
-*  and handles the rendering for the screen
+/** Task: advances the ball every PONG_PERIOD, sounding a tone when
+ *  a point is scored
+ */
+void moveStep(Task *task)
+{
+  int red = redScore, white = whiteScore;
+  P1OUT |= GREEN_LED;		/**< Green LED on when cpu on */
+  pongAdvance(&ml1, &ml0, &ml0, &fieldFence); //ml0 = white = layer 1; ml1 = red = layer1; ml3 = ball = layer3 ; 
+  if (red != redScore || white != whiteScore) {
+    buzzer_set_period(TONE_PERIOD);
+    timerStart(&toneTimer, TONE_LENGTH, 0);
+  }
+  taskPost(&drawTask);
+}
+
+/** Task: silences the buzzer after a point's tone */
+void toneOffStep(Task *task)
+{
+  buzzer_set_period(0);
+}
+
+/** Task: redraws the scores and the layers that moved */
+void drawStep(Task *task)
+{
+  drawString5x7(20,0, "Welcome to Pong!", COLOR_GREEN, COLOR_BLACK);
+  drawString5x7(25,151, ":P1 Score P2:", COLOR_GREEN, COLOR_BLACK);
+  drawString5x7(3, 151, printRed, COLOR_RED, COLOR_BLACK);
+  drawString5x7(120, 151, printWhite, COLOR_WHITE, COLOR_BLACK);
+  movLayerDraw(&ml0, &layer0);
+  P1OUT &= ~GREEN_LED;		/**< Green LED off until the next task */
+}
+
+
+/** Initializes everything and turns on the green LED, then leaves
+*  motion, rendering and sound to scheduled tasks
 */
 void main()
 {
@@ -300,10 +352,14 @@ void main()
   P1OUT |= GREEN_LED;
 
   configureClocks();
+  timebaseInit();		/**< clocks the switches and the moves */
   buzzer_init();
   lcd_init();
   shapeInit();
+  abCircleInit();		/**< circles render & collide by chords */
   p2sw_init(15);
+  p2sw_set_clock(pongTicks, 5); /**< edges within 20ms of a change are bounces */
+  p2sw_set_handler(pongSwitches);
 
   shapeInit();
 
@@ -316,39 +372,7 @@ void main()
   layerGetBounds(&layer0, &fieldPaddleWhite);
   layerGetBounds(&layer2, &fieldBall);
   
-  enableWDTInterrupts();      /**< enable periodic interrupt */
-  or_sr(0x8);	              /**< GIE (enable interrupts) */
-  u_int button;
-
-
-  for(;;) { 
-    button = p2sw_read();
-    while (!redrawScreen) { /**< Pause CPU if screen doesn't need updating */
-      P1OUT &= ~GREEN_LED;    /**< Green led off witHo CPU */
-      or_sr(0x10);	      /**< CPU OFF */
-    }
-    
-    p1(button);
-    p2(button);
-    P1OUT |= GREEN_LED;       /**< Green led on when CPU on */
-    redrawScreen = 0;
-    movLayerDraw(&ml0, &layer0);
-    //buzzer1();
-
-  }
-}
-
-/** Watchdog timer interrupt handler. 15 interrupts/sec */
-void wdt_c_handler()
-{
-  static short count = 0;
-  P1OUT |= GREEN_LED;		      /**< Green LED on when cpu on */
-  count ++;
-  if (count == 15) {
-    mlAdvance(&ml1, &ml0, &ml0, &fieldFence); //ml0 = white = layer 1; ml1 = red = layer1; ml3 = ball = layer3 ; 
-    if (p2sw_read())
-      redrawScreen = 1;
-    count = 0;
-  } 
-  P1OUT &= ~GREEN_LED;		    /**< Green LED off when cpu off */
+  timerStart(&moveTimer, PONG_PERIOD, PONG_PERIOD); /**< moves the ball */
+  taskPost(&drawTask);          /**< titles and scores */
+  schedRun();                   /**< runs tasks, sleeping when none are ready */
 }
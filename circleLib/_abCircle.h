@@ -6,8 +6,8 @@
 /** AbShape circle
  *  
  *  chords should be a vector of length radius + 1.  
- *  Entry at index i is 1/2 chord length at distance i from the circle's center.  
- *  This vector can be generated using lcdLib's computeChordVec() (lcddraw.h).
+ *  Entry at index i is 1/2 chord length at distance i (rows) from the circle's center.  
+ *  This vector can be generated using computeChordVec().
  */ 
 typedef struct AbCircle_s {
   void (*getBounds)(const struct AbCircle_s *circle, const Vec2 *centerPos, Region *bounds);
@@ -24,6 +24,102 @@ void abCircleGetBounds(const AbCircle *circle, const Vec2 *circlePos, Region *bo
  */
 int abCircleCheck(const AbCircle *circle, const Vec2 *circlePos, const Vec2 *pixel);
 
+/** Required by AbSpanClass
+ */
+int abCircleRowSpans(const AbCircle *circle, const Vec2 *circlePos, int row, Span *spans);
+
+/** AbShape ellipse with horizontal radius rx and vertical radius ry
+ *
+ *  chords should be a vector of length ry + 1.
+ *  Entry at index i is 1/2 chord length at distance i (rows) from the ellipse's center.
+ *  makeCircles generates these for the sizes listed in ELLIPSES (see Makefile).
+ */
+typedef struct AbEllipse_s {
+  void (*getBounds)(const struct AbEllipse_s *ellipse, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbEllipse_s *ellipse, const Vec2 *centerPos, const Vec2 *pixel);
+  const u_char *chords;
+  const u_char rx, ry;
+} AbEllipse;
+
+/** Quadrants of a ring (an arc draws only the ones selected) */
+#define ARC_UR 1		/**< upper right */
+#define ARC_UL 2		/**< upper left */
+#define ARC_LL 4		/**< lower left */
+#define ARC_LR 8		/**< lower right */
+#define ARC_ALL 15		/**< a full ring */
+
+/** AbShape ring: the pixels of an outer circle that aren't in an inner one.
+ *
+ *  outerChords and innerChords are chord vectors (e.g. chordVec20 and
+ *  chordVec16) for radii outerRadius > innerRadius.  Only the quadrants
+ *  selected in quadrants are drawn, so an arc is a ring with fewer than
+ *  all four quadrants.  Pixels on an axis belong to both quadrants
+ *  they border.
+ */
+typedef struct AbRing_s {
+  void (*getBounds)(const struct AbRing_s *ring, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbRing_s *ring, const Vec2 *centerPos, const Vec2 *pixel);
+  const u_char *outerChords, *innerChords;
+  const u_char outerRadius, innerRadius;
+  u_char quadrants;		/* ARC_ bits */
+} AbRing;
+
+/** Required by AbShape
+ */
+void abEllipseGetBounds(const AbEllipse *ellipse, const Vec2 *centerPos, Region *bounds);
+
+/** Required by AbShape
+ */
+int abEllipseCheck(const AbEllipse *ellipse, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** Required by AbSpanClass
+ */
+int abEllipseRowSpans(const AbEllipse *ellipse, const Vec2 *centerPos, int row, Span *spans);
+
+/** Required by AbShape
+ */
+void abRingGetBounds(const AbRing *ring, const Vec2 *centerPos, Region *bounds);
+
+/** Required by AbShape
+ */
+int abRingCheck(const AbRing *ring, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** Required by AbSpanClass.  Yields up to two spans per row.
+ */
+int abRingRowSpans(const AbRing *ring, const Vec2 *centerPos, int row, Span *spans);
+
+/** Fills chordVec (of length radius + 1) with a circle's 1/2 chord lengths
+ */
+void computeChordVec(u_char chordVec[], u_char radius);
+
+#ifndef CHORD_POOL_BYTES
+#define CHORD_POOL_BYTES 48	/**< chord storage shared by acquired circles */
+#endif
+#ifndef CHORD_POOL_CIRCLES
+#define CHORD_POOL_CIRCLES 4	/**< distinct radii acquired at once */
+#endif
+
+/** Returns a circle of radius whose chords are computed into a small
+ *  shared pool, rather than generated into flash by makeCircles.
+ *
+ *  Circles of the same radius are shared and reference counted.
+ *
+ *  \return The circle, or 0 if the pool lacks a free circle or
+ *  radius + 1 contiguous bytes of chords
+ */
+const AbCircle *abCircleAcquire(u_char radius);
+
+/** Releases a circle returned by abCircleAcquire.  Its chords are
+ *  reclaimed when its last user releases it.
+ */
+void abCircleRelease(const AbCircle *circle);
+
+/** Registers the row spans of circles, ellipses and rings with shapeLib
+ *  (see abShapeRowSpans) so that overlap tests on them use chords
+ *  rather than per-pixel checks
+ */
+void abCircleInit();
+
 #endif
 
 
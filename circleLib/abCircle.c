@@ -4,12 +4,158 @@
 // true if pixel is in circle centered at centerPos
 int abCircleCheck(const AbCircle *circle, const Vec2 *centerPos, const Vec2 *pixel)
 {
-  u_char radius = circle->radius;
-  int axis;
-  Vec2 relPos;
-  vec2Sub(&relPos, pixel, centerPos); /* vector from center to pixel */
-  vec2Abs(&relPos);		      /* project to first quadrant */
-  return (relPos.axes[0] <= radius && circle->chords[relPos.axes[0]] >= relPos.axes[1]);
+  int col = pixel->axes[0] - centerPos->axes[0], row = pixel->axes[1] - centerPos->axes[1];
+  if (col < 0) col = -col;	/* project to first quadrant */
+  if (row < 0) row = -row;
+  return row <= circle->radius && circle->chords[row] >= col;
+}
+
+// the chord at this row's distance from center
+int
+abCircleRowSpans(const AbCircle *circle, const Vec2 *centerPos, int row, Span *spans)
+{
+  int halfChord;
+  row -= centerPos->axes[1];
+  if (row < 0)
+    row = -row;
+  if (row > circle->radius)
+    return 0;
+  halfChord = circle->chords[row];
+  spans[0].colStart = centerPos->axes[0] - halfChord;
+  spans[0].colEnd = centerPos->axes[0] + halfChord;
+  return 1;
+}
+
+// true if pixel is in ellipse centered at centerPos
+int
+abEllipseCheck(const AbEllipse *ellipse, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  int col = pixel->axes[0] - centerPos->axes[0], row = pixel->axes[1] - centerPos->axes[1];
+  if (col < 0) col = -col;	/* project to first quadrant */
+  if (row < 0) row = -row;
+  return row <= ellipse->ry && ellipse->chords[row] >= col;
+}
+
+// the chord at this row's distance from center
+int
+abEllipseRowSpans(const AbEllipse *ellipse, const Vec2 *centerPos, int row, Span *spans)
+{
+  int halfChord;
+  row -= centerPos->axes[1];
+  if (row < 0)
+    row = -row;
+  if (row > ellipse->ry)
+    return 0;
+  halfChord = ellipse->chords[row];
+  spans[0].colStart = centerPos->axes[0] - halfChord;
+  spans[0].colEnd = centerPos->axes[0] + halfChord;
+  return 1;
+}
+
+void
+abEllipseGetBounds(const AbEllipse *ellipse, const Vec2 *centerPos, Region *bounds)
+{
+  bounds->topLeft.axes[0] = centerPos->axes[0] - ellipse->rx;
+  bounds->topLeft.axes[1] = centerPos->axes[1] - ellipse->ry;
+  bounds->botRight.axes[0] = centerPos->axes[0] + ellipse->rx;
+  bounds->botRight.axes[1] = centerPos->axes[1] + ellipse->ry;
+}
+
+// quadrants of ring drawn on the left & right of a row (dRow from center)
+static void
+ringSides(const AbRing *ring, int dRow, u_char *left, u_char *right)
+{
+  u_char q = ring->quadrants;
+  if (dRow < 0) {
+    *left = q & ARC_UL;
+    *right = q & ARC_UR;
+  } else if (dRow > 0) {
+    *left = q & ARC_LL;
+    *right = q & ARC_LR;
+  } else {			/* horizontal axis borders all four */
+    *left = q & (ARC_UL | ARC_LL);
+    *right = q & (ARC_UR | ARC_LR);
+  }
+}
+
+// true if pixel is in ring centered at centerPos
+int
+abRingCheck(const AbRing *ring, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  int col = pixel->axes[0] - centerPos->axes[0], row = pixel->axes[1] - centerPos->axes[1];
+  u_char left, right;
+  ringSides(ring, row, &left, &right);
+  if (col < 0) {		/* project to first quadrant */
+    if (!left) return 0;
+    col = -col;
+  } else if (!right && (col > 0 || !left)) {
+    return 0;
+  }
+  if (row < 0) row = -row;
+  return row <= ring->outerRadius && ring->outerChords[row] >= col &&
+    (row > ring->innerRadius || ring->innerChords[row] < col);
+}
+
+// outer chord less inner chord: one span, or two where the row crosses the hole
+int
+abRingRowSpans(const AbRing *ring, const Vec2 *centerPos, int row, Span *spans)
+{
+  int center = centerPos->axes[0], outer, inner, n = 0;
+  u_char left, right;
+  row -= centerPos->axes[1];
+  ringSides(ring, row, &left, &right);
+  if (row < 0)
+    row = -row;
+  if (row > ring->outerRadius || !(left || right))
+    return 0;
+  outer = ring->outerChords[row];
+  if (row > ring->innerRadius) { /* above or below the hole */
+    spans[0].colStart = left ? center - outer : center;
+    spans[0].colEnd = right ? center + outer : center;
+    return 1;
+  }
+  inner = ring->innerChords[row];
+  if (inner >= outer)		/* no pixels between the circles */
+    return 0;
+  if (left) {
+    spans[n].colStart = center - outer;
+    spans[n++].colEnd = center - inner - 1;
+  }
+  if (right) {
+    spans[n].colStart = center + inner + 1;
+    spans[n++].colEnd = center + outer;
+  }
+  return n;
+}
+
+void
+abRingGetBounds(const AbRing *ring, const Vec2 *centerPos, Region *bounds)
+{
+  u_char axis, radius = ring->outerRadius;
+  for (axis = 0; axis < 2; axis ++) {
+    bounds->topLeft.axes[axis] = centerPos->axes[axis] - radius;
+    bounds->botRight.axes[axis] = centerPos->axes[axis] + radius;
+  }
+}
+
+static AbSpanClass ringSpans = {
+  (AbCheckFn)abRingCheck, (AbRowSpansFn)abRingRowSpans, 0
+};
+
+static AbSpanClass ellipseSpans = {
+  (AbCheckFn)abEllipseCheck, (AbRowSpansFn)abEllipseRowSpans, 0
+};
+
+static AbSpanClass circleSpans = {
+  (AbCheckFn)abCircleCheck, (AbRowSpansFn)abCircleRowSpans, 0
+};
+
+void
+abCircleInit()
+{
+  abShapeRegisterSpans(&circleSpans);
+  abShapeRegisterSpans(&ellipseSpans);
+  abShapeRegisterSpans(&ringSpans);
 }
   
 void
@@ -20,6 +166,5 @@ abCircleGetBounds(const AbCircle *circle, const Vec2 *centerPos, Region *bounds)
     bounds->topLeft.axes[axis] = centerPos->axes[axis] - radius;
     bounds->botRight.axes[axis] = centerPos->axes[axis] + radius;
   }
-  regionClipScreen(bounds);
 }
 
@@ -0,0 +1,72 @@
+#include "shape.h"
+#include "_abCircle.h"
+
+/* a circle built at run time and the number of its users */
+typedef struct {
+  AbCircle circle;
+  u_char refs;
+} PooledCircle;
+
+static u_char chordBytes[CHORD_POOL_BYTES]; /* shared by every pooled circle */
+static PooledCircle pooled[CHORD_POOL_CIRCLES];
+
+/* offset of the first gap of size bytes between live circles' chords, or -1 */
+static int
+chordGap(int size)
+{
+  int start = 0, i = 0;
+  while (i < CHORD_POOL_CIRCLES) {
+    const PooledCircle *p = &pooled[i];
+    int off, end;
+    if (start + size > CHORD_POOL_BYTES)
+      return -1;
+    if (p->refs) {
+      off = p->circle.chords - chordBytes;
+      end = off + p->circle.radius + 1;
+      if (start < end && off < start + size) { /* overlaps: skip past it */
+	start = end;
+	i = 0;			/* and recheck every circle */
+	continue;
+      }
+    }
+    i++;
+  }
+  return start;
+}
+
+const AbCircle *
+abCircleAcquire(u_char radius)
+{
+  PooledCircle *p, *slot = 0;
+  int i, off;
+  for (i = 0; i < CHORD_POOL_CIRCLES; i++) {
+    p = &pooled[i];
+    if (!p->refs) {
+      if (!slot)
+	slot = p;
+    } else if (p->circle.radius == radius) { /* share */
+      p->refs++;
+      return &p->circle;
+    }
+  }
+  if (!slot || (off = chordGap((int)radius + 1)) < 0)
+    return 0;			/* pool exhausted */
+  computeChordVec(chordBytes + off, radius);
+  slot->circle.getBounds = abCircleGetBounds;
+  slot->circle.check = abCircleCheck;
+  slot->circle.chords = chordBytes + off;
+  *(u_char *)&slot->circle.radius = radius; /* radius is const once built */
+  slot->refs = 1;
+  return &slot->circle;
+}
+
+void
+abCircleRelease(const AbCircle *circle)
+{
+  int i;
+  for (i = 0; i < CHORD_POOL_CIRCLES; i++)
+    if (&pooled[i].circle == circle && pooled[i].refs) {
+      pooled[i].refs--;
+      return;
+    }
+}
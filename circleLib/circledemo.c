@@ -29,6 +29,7 @@ main()
 {
   configureClocks();
   lcd_init();
+  abCircleInit();
 
   clearScreen(COLOR_BLUE);
   drawString5x7(20,20, "hello", COLOR_GREEN, COLOR_RED);
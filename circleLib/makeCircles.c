@@ -1,50 +1,81 @@
+// shared with the library's runtime chord pool (chords.c)
+void computeChordVec(unsigned char chordVec[], unsigned char radius);
+
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "assert.h"
 
 ///////////////////////////////////////////
-// build table chordVec[d] of circle 1/2 widths at distances d from center
-// Code adapted from RobG's EduKit
-// Uses Bresenham's circle algorithm
-// Modified from RobG's EduKit by Eric Freudenthal and David Pruitt 2016
+// build table chords[d] of ellipse 1/2 widths at distances d (rows) from center
+// chords[d] is the largest x whose pixel's inner edge, x - 1/2, is within
+// the ellipse: ((x - 1/2)/rx)**2 + (d/ry)**2 <= 1, which for rx == ry
+// closely matches computeChordVec's circles.  In integers:
+// (2x - 1)**2 * ry**2 + 4 * d**2 * rx**2 <= 4 * rx**2 * ry**2
 ///////////////////////////////////////////
-void computeChordVec(unsigned char chordVec[], unsigned char radius) 
+void computeEllipseChords(unsigned char chords[], int rx, int ry)
 {
-  int col = radius, row = 0;	/* first coordinate (radius, 0) */
-  
-  // key insight: (col+1)**2 - col**2 = 2col+1
-  
-  int dColSquared = 2 * col - 1;  // change in col**2 for a unit decrease in col
-  int dRowSquared = 1;	    // change in row**2 for a unit increase in row
-
-  int radiusSqErr = 0;		/* (radius, 0) is on the circle  */
-  int colPrev = 0;		/* initially bogus value  to force first entry*/
-  while (col >= row) {		/* only sweep first octant */
-    chordVec[row] = col;      /* row always changes in first octant */
-
-    /* mirror into 2nd octant */
-    if (colPrev != col)		/* col sometimes repeats in first octant */
-      chordVec[col] = row;	/* only save first (max) col for row */
-    colPrev = col;
-
-    row++;			/* move vertically (slope <= -1 for first octant) */
-    radiusSqErr += dRowSquared;	/* current radiusSqErr */
-    dRowSquared += 2; 		/* next dRowSquared */
-    if ((2 * radiusSqErr) > dColSquared) { /* only update col if error reduced */
-      col--;			/* move horizontally */
-      radiusSqErr -= dColSquared;	/* current radiusSqErr */
-      dColSquared -= 2;	      /* next dColSquared */
-    }
+  long limit = 4L * rx * rx * ry * ry;
+  int row, col = rx;
+  for (row = 0; row <= ry; row++) {
+    long rowTerm = 4L * row * row * rx * rx;
+    while (col > 0 && (long)(2 * col - 1) * (2 * col - 1) * ry * ry + rowTerm > limit)
+      col--;			/* chords shrink as row grows */
+    chords[row] = col;
   }
 }
 
-#include "stdio.h"
-#include "assert.h"
-
+// parse "AxB" into *a and *b
+static void
+parseSize(const char *arg, int *a, int *b)
+{
+  if (sscanf(arg, "%dx%d", a, b) != 2) {
+    fprintf(stderr, "makeCircles: expected WxH, got %s\n", arg);
+    exit(1);
+  }
+}
 
 // Generate circles as source files
 // (c) Eric Freudenthal, 2016
-int main()
+//
+// usage: makeCircles [-e RXxRY]... [-r OUTERxINNER]... [radius]...
+//   generates circleN and chordVecN for each radius listed (2..150),
+//   or for every radius if none are listed
+//   -e generates ellipseRXxRY (and its chords, ellipseChordsRXxRY)
+//   -r generates ringOUTERxINNER from the circles' chordVecs, adding
+//      OUTER and INNER to the radii
+int main(int argc, char **argv)
 {
-  int radius;
-  char chordVec[151];
+  int radius, arg, nRadii = 0;
+  unsigned char chordVec[151];
+  char want[151];		/* want[r]: generate circle r */
+
+  memset(want, 0, sizeof want);
+  for (arg = 1; arg < argc; arg++) { /* collect radii */
+    int a, b;
+    if (!strcmp(argv[arg], "-e") && arg + 1 < argc) {
+      arg++;
+    } else if (!strcmp(argv[arg], "-r") && arg + 1 < argc) {
+      parseSize(argv[++arg], &a, &b);
+      if (b < 2 || a <= b || a > 150) {
+	fprintf(stderr, "makeCircles: ring radii must satisfy 2 <= inner < outer <= 150\n");
+	return 1;
+      }
+      want[a] = want[b] = 1;
+    } else if (sscanf(argv[arg], "%d", &radius) == 1) {
+      if (radius < 2 || radius > 150) { /* e.g. a scanned "circle1" */
+	fprintf(stderr, "makeCircles: ignoring radius %d (not 2..150)\n", radius);
+	continue;
+      }
+      want[radius] = 1;
+      nRadii++;
+    } else {
+      fprintf(stderr, "usage: makeCircles [-e RXxRY]... [-r OUTERxINNER]... [radius]...\n");
+      return 1;
+    }
+  }
+  if (!nRadii)			/* none listed: all of them */
+    memset(want, 1, sizeof want);
   FILE *circleIncludeFile = fopen("abCircle_decls.h", "w");
   FILE *chordIncludeFile = fopen("chordVec.h", "w");
   assert(chordIncludeFile); assert(circleIncludeFile);
@@ -59,6 +90,8 @@ int main()
     char filename[100];
     unsigned char chordIndex;
     
+    if (!want[radius])
+      continue;
     computeChordVec(chordVec, radius);
 
     {				/* chordVecN.c */
@@ -89,6 +122,59 @@ int main()
     fprintf(circleIncludeFile, "extern const AbCircle circle%d;\n" , radius);
   }
 
+  for (arg = 1; arg < argc; arg++) {
+    char filename[100];
+    int a, b, chordIndex;
+    FILE *fp;
+    if (!strcmp(argv[arg], "-e") && arg + 1 < argc) {	/* ellipse */
+      parseSize(argv[++arg], &a, &b);
+      if (a < 1 || a > 150 || b < 1 || b > 150) {
+	fprintf(stderr, "makeCircles: ellipse radii must be 1..150\n");
+	return 1;
+      }
+      computeEllipseChords(chordVec, a, b);
+
+      sprintf(filename, "circles/ellipseChords%dx%d.c", a, b);
+      fp = fopen(filename, "w");
+      assert(fp);
+      fprintf(fp, "// Automatically generated by makeCircles.  (c) Eric Freudenthal, 2016\n");
+      fprintf(fp, "#include \"chordVec.h\"\n\n");
+      fprintf(fp, "const unsigned char ellipseChords%dx%d[%d] = {\n", a, b, b+1);
+      for (chordIndex = 0; chordIndex <= b; chordIndex ++)
+	fprintf(fp, "    %d, // dist along axis = %d\n", chordVec[chordIndex], chordIndex);
+      fprintf(fp, "};\n\n");
+      fclose(fp);
+
+      sprintf(filename, "circles/abEllipse%dx%d.c", a, b);
+      fp = fopen(filename, "w");
+      assert(fp);
+      fprintf(fp, "// Automatically generated by makeCircles.  (c) Eric Freudenthal, 2016\n");
+      fprintf(fp, "#include \"abCircle.h\"\n\n");
+      fprintf(fp, "#include \"chordVec.h\"\n\n");
+      fprintf(fp, "const AbEllipse ellipse%dx%d = {", a, b);
+      fprintf(fp, "  abEllipseGetBounds, abEllipseCheck, ellipseChords%dx%d, %d, %d", a, b, a, b);
+      fprintf(fp, "};\n");
+      fclose(fp);
+
+      fprintf(chordIncludeFile, "extern const unsigned char ellipseChords%dx%d[%d];\n", a, b, b+1);
+      fprintf(circleIncludeFile, "extern const AbEllipse ellipse%dx%d;\n", a, b);
+    } else if (!strcmp(argv[arg], "-r") && arg + 1 < argc) { /* ring */
+      parseSize(argv[++arg], &a, &b); /* checked above */
+      sprintf(filename, "circles/abRing%dx%d.c", a, b);
+      fp = fopen(filename, "w");
+      assert(fp);
+      fprintf(fp, "// Automatically generated by makeCircles.  (c) Eric Freudenthal, 2016\n");
+      fprintf(fp, "#include \"abCircle.h\"\n\n");
+      fprintf(fp, "#include \"chordVec.h\"\n\n");
+      fprintf(fp, "const AbRing ring%dx%d = {", a, b);
+      fprintf(fp, "  abRingGetBounds, abRingCheck, chordVec%d, chordVec%d, %d, %d, ARC_ALL", a, b, a, b);
+      fprintf(fp, "};\n");
+      fclose(fp);
+
+      fprintf(circleIncludeFile, "extern const AbRing ring%dx%d;\n", a, b);
+    }				/* radii were handled above */
+  }
+
   fprintf(circleIncludeFile, "\n#endif // included \n");
   fprintf(chordIncludeFile, "\n#endif // included \n");
   fclose(chordIncludeFile);
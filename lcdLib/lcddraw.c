@@ -3,6 +3,7 @@
  */
 #include "lcdutils.h"
 #include "lcddraw.h"
+#include "profile.h"
 
 
 /** Draw single pixel at x,row 
@@ -30,11 +31,7 @@ void fillRectangle(u_char colMin, u_char rowMin, u_char width, u_char height,
 {
   u_char colLimit = colMin + width, rowLimit = rowMin + height;
   lcd_setArea(colMin, rowMin, colLimit - 1, rowLimit - 1);
-  u_int total = width * height;
-  u_int c = 0;
-  while ((c++) < total) {
-    lcd_writeColor(colorBGR);
-  }
+  lcd_writeColorRun(colorBGR, width * height);
 }
 
 /** Clear screen (fill with color)
@@ -59,6 +56,7 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
   u_char bit = 0x01;
   u_char oc = c - 0x20;
 
+  PROFILE_BEGIN(PROFILE_DRAW_CHAR);
   lcd_setArea(rcol, rrow, rcol + 4, rrow + 7); /* relative to requested col/row */
   while (row < 8) {
     while (col < 5) {
@@ -70,6 +68,7 @@ void drawChar5x7(u_char rcol, u_char rrow, char c,
     bit <<= 1;
     row++;
   }
+  PROFILE_END(PROFILE_DRAW_CHAR);
 }
 
 /** Draw string at col,row
@@ -88,10 +87,12 @@ void drawString5x7(u_char col, u_char row, char *string,
 		u_int fgColorBGR, u_int bgColorBGR)
 {
   u_char cols = col;
+  PROFILE_BEGIN(PROFILE_DRAW_STRING);
   while (*string) {
     drawChar5x7(cols, row, *string++, fgColorBGR, bgColorBGR);
     cols += 6;
   }
+  PROFILE_END(PROFILE_DRAW_STRING);
 }
 
 
@@ -10,9 +10,18 @@
  
 #include "lcdutils.h"
 #include "msp430.h"
+#include "clocksTimer.h"
 
 u_char _orientation = 0;
 
+LcdCounts lcdCounts;
+
+#ifdef FRAME_STATS
+#define LCD_COUNT(counter, n) (lcdCounts.counter += (n))
+#else
+#define LCD_COUNT(counter, n) ((void)0)
+#endif
+
 /** LCD pin definitions*/
 /** SCLK & MOSI*/
 #define LCD_SPI_OUT		P1OUT
@@ -52,6 +61,26 @@ u_char _orientation = 0;
 #define GMCTRP1							0xE0
 #define GMCTRN1							0xE1
 
+/** Fastest SPI clock (the LCD accepts up to ~15 MHz) */
+#define LCD_SPI_MAX_HZ 8000000UL
+
+/** SMCLK divisor giving the fastest SPI clock up to LCD_SPI_MAX_HZ */
+static u_char spiDivisor()
+{
+  return (clockSmclkHz() + LCD_SPI_MAX_HZ - 1) / LCD_SPI_MAX_HZ;
+}
+
+/** Rescales SPI after a clock profile change */
+static void spiClockChanged(ClockListener *listener)
+{
+  while (UCB0STAT & UCBUSY);	/**< let the last byte finish */
+  UCB0CTL1 |= UCSWRST;
+  UCB0BR0 = spiDivisor();
+  UCB0CTL1 &= ~UCSWRST;
+}
+
+static ClockListener spiClockListener = { spiClockChanged };
+
 /** Set up onboard LCD's SPI and control pins */
 static void setUpSPIforLCD() {
   LCD_DC_OUT |= LCD_DC_PIN;
@@ -70,10 +99,11 @@ static void setUpSPIforLCD() {
   UCB0CTL1 |= UCSWRST;
   UCB0CTL0 = UCCKPH + UCMSB + UCMST + UCSYNC; /**< 3-pin, 8-bit SPI master */
   UCB0CTL1 |= UCSSEL_2; /**< SMCLK */
-  UCB0BR0 |= 0x01; /**< 1:1 */
+  UCB0BR0 = spiDivisor(); /**< 1:1 at 2 MHz SMCLK, 1:2 at 16 MHz */
   UCB0BR1 = 0;
   UCB0CTL1 &= ~UCSWRST;
   LCD_SELECT();
+  clockAddListener(&spiClockListener);
 }
 
 /** Screen dimensions */
@@ -85,6 +115,7 @@ lcd_writeData(u_char data)
   while (UCB0STAT & UCBUSY);	/**< wait for previous transfer to complete */
   LCD_DC_HI();			/**< specify sending data */
   UCB0TXBUF = data;		/**< send data */
+  LCD_COUNT(spiBytes, 1);
 }
 
 typedef union {
@@ -97,6 +128,18 @@ void lcd_writeColor(u_int colorBGR)
   ColorBGR colorU = {.colorBGRWord = colorBGR};
   lcd_writeData(colorU.colorBytes[1]);
   lcd_writeData(colorU.colorBytes[0]);
+  LCD_COUNT(pixels, 1);
+}
+
+void lcd_writeColorRun(u_int colorBGR, u_int count)
+{
+  ColorBGR colorU = {.colorBGRWord = colorBGR};
+  u_char hi = colorU.colorBytes[1], lo = colorU.colorBytes[0];
+  LCD_COUNT(pixels, count);
+  for (; count; count--) {
+    lcd_writeData(hi);
+    lcd_writeData(lo);
+  }
 }
 
 /** Write command to LCD (private) */
@@ -105,6 +148,7 @@ void _writeCommand(u_char command)
   while (UCB0STAT & UCBUSY);	/**< wait for previous transfer to complete */
   LCD_DC_LO();			          /**< specify sending a command */
   UCB0TXBUF = command;		    /**< send command */
+  LCD_COUNT(spiBytes, 1);
 }
 
 /** Long delay (private) */
@@ -118,6 +162,7 @@ void _delay(u_char x10ms) {
 /** Set area to draw to */
 void lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd) 
 {
+	LCD_COUNT(setAreas, 1);
 	_writeCommand(CASETP);
 	lcd_writeData(0);
 	lcd_writeData(colStart);
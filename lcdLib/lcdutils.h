@@ -56,6 +56,25 @@ void lcd_setArea(u_char colStart, u_char rowStart, u_char colEnd, u_char rowEnd)
  */
 void lcd_writeColor(u_int colorBGR);
 
+/** Write the same color to the next count pixels
+ *
+ *  \param colorBGR The color in BGR
+ *  \param count Number of pixels
+ */
+void lcd_writeColorRun(u_int colorBGR, u_int count);
+
+/** Work done by the driver since the counts were last cleared.
+ *  Counted only when lcdLib is compiled with -DFRAME_STATS ("make
+ *  FRAME_STATS=1"); shapeLib's frameStatsEnd() collects and clears them.
+ */
+typedef struct {
+  unsigned long pixels;		/**< colors written */
+  unsigned long spiBytes;	/**< command & data bytes sent */
+  u_int setAreas;		/**< lcd_setArea calls */
+} LcdCounts;
+
+extern LcdCounts lcdCounts;
+
 #define rgb2bgr(val) ((((val) << 11)&0xf800) | ((val)&0x7e0) | (((val)>>11)&0x1f))
 
 /** Colors */
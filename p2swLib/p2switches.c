@@ -1,17 +1,67 @@
 #include <msp430.h>
 #include "p2switches.h"
+#include "timebase.h"
+#include "isr.h"
 
 static unsigned char switch_mask;
 static unsigned char switches_last_reported;
-static unsigned char switches_current;
+static unsigned char switches_current; /* debounced */
+
+static unsigned int (*switch_clock)();
+static unsigned int switch_debounce, switch_last_change;
+static P2swHandler switch_handler;
+
+/* single-producer (interrupts, which must not nest: isr.h),
+   single-consumer (p2sw_next_event) ring */
+static P2swEvent switch_events[P2SW_QUEUE_LEN];
+static volatile unsigned char switch_head, switch_tail;
+unsigned char p2sw_overflows;
+unsigned int p2sw_events;
+
+/* keeps the compiler from reordering the ring's stores around its indices */
+#define MEMORY_BARRIER() __asm__ __volatile__ ("" ::: "memory")
 
 static void
-switch_update_interrupt_sense()
+switch_update_interrupt_sense(unsigned char sensed)
 {
-  switches_current = P2IN & switch_mask;
   /* update switch interrupt to detect changes from current buttons */
-  P2IES |= (switches_current);  /* if switch up, sense down */
-  P2IES &= (switches_current | ~switch_mask); /* if switch down, sense up */
+  P2IES |= (sensed);  /* if switch up, sense down */
+  P2IES &= (sensed | ~switch_mask); /* if switch down, sense up */
+}
+
+/* samples the switches and queues any debounced change (interrupt
+   context); returns nonzero if the handler asked to wake the CPU */
+static int
+switch_sample()
+{
+  unsigned char sensed = P2IN & switch_mask, changed, next;
+  unsigned int now = switch_clock ? switch_clock() : 0;
+  switch_update_interrupt_sense(sensed);
+  changed = sensed ^ switches_current;
+  if (!changed || (switch_debounce && now - switch_last_change < switch_debounce))
+    return 0;			/* nothing new, or still bouncing */
+  switches_current = sensed;
+  switch_last_change = now;
+  p2sw_events++;
+
+  if (switch_handler) {		/* deliver right away */
+    P2swEvent event;
+    event.state = sensed;
+    event.changed = changed;
+    event.time = now;
+    return switch_handler(&event);
+  }
+  next = (switch_head + 1) & (P2SW_QUEUE_LEN - 1);
+  if (next == switch_tail) {	/* full: drop this one */
+    p2sw_overflows++;
+    return 0;
+  }
+  switch_events[switch_head].state = sensed;
+  switch_events[switch_head].changed = changed;
+  switch_events[switch_head].time = now;
+  MEMORY_BARRIER();
+  switch_head = next;		/* publish */
+  return 0;
 }
 
 void 
@@ -23,7 +73,21 @@ p2sw_init(unsigned char mask)
   P2OUT |= mask;    /* pull-ups for switches */
   P2DIR &= ~mask;   /* set switches' bits for input */
 
-  switch_update_interrupt_sense();
+  switches_current = P2IN & mask;
+  switch_update_interrupt_sense(switches_current);
+}
+
+void
+p2sw_set_handler(P2swHandler handler)
+{
+  switch_handler = handler;
+}
+
+void
+p2sw_set_clock(unsigned int (*now)(), unsigned int debounce)
+{
+  switch_clock = now;
+  switch_debounce = debounce;
 }
 
 /* Returns a word where:
@@ -32,16 +96,43 @@ p2sw_init(unsigned char mask)
  */
 unsigned int 
 p2sw_read() {
-  unsigned int sw_changed = switches_current ^ switches_last_reported;
-  switches_last_reported = switches_current;
-  return switches_current | (sw_changed << 8);
+  unsigned char current = switches_current;
+  unsigned int sw_changed = current ^ switches_last_reported;
+  switches_last_reported = current;
+  return current | (sw_changed << 8);
 }
 
-/* Switch on P2 (S1) */
-void
-__interrupt_vec(PORT2_VECTOR) Port_2(){
+int
+p2sw_next_event(P2swEvent *event)
+{
+  unsigned char tail = switch_tail;
+  if (tail == switch_head)
+    return 0;			/* empty */
+  MEMORY_BARRIER();
+  *event = switch_events[tail];
+  MEMORY_BARRIER();
+  switch_tail = (tail + 1) & (P2SW_QUEUE_LEN - 1); /* release the slot */
+  return 1;
+}
+
+int
+p2sw_poll()
+{
+  return switch_sample();
+}
+
+/* Switch on P2 (S1); nonzero wakes the CPU */
+int
+p2sw_interrupt()
+{
+  int wake = 0;
+  ISR_TIME_BEGIN();
   if (P2IFG & switch_mask) {  /* did a button cause this interrupt? */
     P2IFG &= ~switch_mask;	/* clear pending sw interrupts */
-    switch_update_interrupt_sense();
+    wake = switch_sample();
   }
+  ISR_TIME_END();
+  return wake;
 }
+
+ISR_TRAMPOLINE(PORT2, p2sw_interrupt, 0);
@@ -6,4 +6,59 @@
 unsigned int p2sw_read();
 void p2sw_init(unsigned char mask);
 
+/** A debounced change of the switches, recorded by the PORT2 interrupt */
+typedef struct {
+  unsigned char state;		/* all switches after the change (bit clear = down) */
+  unsigned char changed;	/* the switches that changed */
+  unsigned int time;		/* clock ticks when it happened */
+} P2swEvent;
+
+/** Number of events the queue holds (a power of two) */
+#define P2SW_QUEUE_LEN 8
+
+/** Sets the clock that timestamps events.
+ *
+ *  \param now (in) Returns the current tick count (called from interrupts)
+ *  \param debounce (in) Edges within this many ticks of the last
+ *  accepted change are treated as bounces.  0 disables debouncing.
+ *  Without a clock, events are stamped 0 and not debounced.
+ */
+void p2sw_set_clock(unsigned int (*now)(), unsigned int debounce);
+
+/** Removes the oldest switch event from the queue into *event.
+ *
+ *  \return 1 if an event was returned, 0 if the queue was empty
+ */
+int p2sw_next_event(P2swEvent *event);
+
+/** Rechecks the switches for changes that ended during a bounce.
+ *
+ *  Call from a periodic interrupt handler (e.g. the WDT's) when
+ *  debouncing, so that a release which settles inside the debounce
+ *  window is still reported.
+ *
+ *  \return Nonzero if a handler (see p2sw_set_handler) asked to wake
+ *  the CPU; the caller's interrupt handler should then do so
+ */
+int p2sw_poll();
+
+/** Type of a switch event handler.  Called from the PORT2 interrupt.
+ *
+ *  \return Nonzero to wake the CPU from low-power mode on return
+ */
+typedef int (*P2swHandler)(const P2swEvent *event);
+
+/** Installs handler (0 to remove it).
+ *
+ *  While a handler is installed, events are passed to it as soon as
+ *  they happen instead of being queued for p2sw_next_event.
+ */
+void p2sw_set_handler(P2swHandler handler);
+
+/** Events lost because the queue was full */
+extern unsigned char p2sw_overflows;
+
+/** Debounced changes seen so far (wraps) */
+extern unsigned int p2sw_events;
+
 #endif // included
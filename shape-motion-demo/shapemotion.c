@@ -13,6 +13,10 @@
 #include <p2switches.h>
 #include <shape.h>
 #include <abCircle.h>
+#include <framestats.h>
+#if defined(PCSAMPLE) || defined(TELEMETRY)
+#include <uart.h>
+#endif
 
 #define GREEN_LED BIT6
 
@@ -67,97 +71,65 @@ Layer layer0 = {		/**< Layer with an orange circle */
   &layer1,
 };
 
-/** Moving Layer
- *  Linked list of layer references
- *  Velocity represents one iteration of change (direction & magnitude)
- */
-typedef struct MovLayer_s {
-  Layer *layer;
-  Vec2 velocity;
-  struct MovLayer_s *next;
-} MovLayer;
-
 /* initial value of {0,0} will be overwritten */
-MovLayer ml3 = { &layer3, {1,1}, 0 }; /**< not all layers move */
+MovLayer ml3 = { &layer3, {1,1}, 0, 2 }; /**< not all layers move; this one every 2nd tick */
 MovLayer ml1 = { &layer1, {1,2}, &ml3 }; 
 MovLayer ml0 = { &layer0, {2,1}, &ml1 }; 
 
-//Just draws anything aorund a moving layer 
-void movLayerDraw(MovLayer *movLayers, Layer *layers)
-{
-  int row, col;
-  MovLayer *movLayer;
-
-  and_sr(~8);			/**< disable interrupts (GIE off) */ //Turn off all interrupts 
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Layer *l = movLayer->layer;
-    l->posLast = l->pos;
-    l->pos = l->posNext;
-  }
-  or_sr(8);			/**< disable interrupts (GIE on) */ //Turn on all interupts
-
-
-  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
-    Region bounds;
-    layerGetBounds(movLayer->layer, &bounds); 
-    lcd_setArea(bounds.topLeft.axes[0], bounds.topLeft.axes[1], 
-		bounds.botRight.axes[0], bounds.botRight.axes[1]);
-	//For every pixel in the area..
-    for (row = bounds.topLeft.axes[1]; row <= bounds.botRight.axes[1]; row++) {
-      for (col = bounds.topLeft.axes[0]; col <= bounds.botRight.axes[0]; col++) {
-	Vec2 pixelPos = {col, row};
-	u_int color = bgColor;
-	Layer *probeLayer; //We probe to get the colors..
-	for (probeLayer = layers; probeLayer; 
-	     probeLayer = probeLayer->next) { /* probe all layers, in order */
-	  if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-	    color = probeLayer->color;
-	    break; 
-	  } /* if probe check */
-	} // for checking all layers at col, row
-	lcd_writeColor(color); 
-      } // for col
-    } // for row
-  } // for moving layer being updated
-}	  
-
-
-
-//Region fence = {{10,30}, {SHORT_EDGE_PIXELS-10, LONG_EDGE_PIXELS-10}}; /**< Create a fence region */
-
-/** Advances a moving shape within a fence
- *  
- *  \param ml The moving shape to be advanced
- *  \param fence The region which will serve as a boundary for ml
- */
-void mlAdvance(MovLayer *ml, Region *fence)
+
+u_int bgColor = COLOR_BLUE;     /**< The background color */
+
+Region fieldFence;		/**< fence around playing field  */
+
+#define MOTION_PERIOD TIMEBASE_MS(60) /**< time between moves */
+
+void drawStep(Task *task);
+void motionStep(Task *task);
+
+Task drawTask = { drawStep, 2 };     /**< redraws what moved */
+Task motionTask = { motionStep, 1 }; /**< physics before drawing */
+SoftTimer motionTimer = { {0}, &motionTask };
+
+/** Task: moves the layers, then has them redrawn */
+void motionStep(Task *task)
 {
-  Vec2 newPos;
-  u_char axis;
-  Region shapeBoundary;
-  for (; ml; ml = ml->next) {
-    vec2Add(&newPos, &ml->layer->posNext, &ml->velocity);
-    abShapeGetBounds(ml->layer->abShape, &newPos, &shapeBoundary);
-    for (axis = 0; axis < 2; axis ++) {
-      if ((shapeBoundary.topLeft.axes[axis] < fence->topLeft.axes[axis]) ||
-	  (shapeBoundary.botRight.axes[axis] > fence->botRight.axes[axis]) ) {
-	int velocity = ml->velocity.axes[axis] = -ml->velocity.axes[axis];
-	newPos.axes[axis] += (2*velocity);
-      }	/**< if outside of fence */
-    } /**< for axis */
-    ml->layer->posNext = newPos;
-  } /**< for ml */
+  P1OUT |= GREEN_LED;		      /**< Green LED on when cpu on */
+  mlAdvance(&ml0, &fieldFence);
+  taskPost(&drawTask);
 }
 
+/** Task: redraws the layers that moved, with SPI at full speed */
+void drawStep(Task *task)
+{
+  clockSetProfile(CLOCK_MAX_SPI);
+  movLayerDraw(&ml0, &layer0);
+#if defined(FRAME_STATS) || defined(TELEMETRY)
+  frameStatsEnd();
+#endif
+#ifdef FRAME_STATS
+  frameOverlayDraw(2, screenHeight - 8, COLOR_WHITE, bgColor); /**< below the field */
+#endif
+#ifdef TELEMETRY
+  telemetry_send();		      /**< to uartLib/telemetry.py */
+#endif
+  clockSetProfile(CLOCK_LOW_POWER);   /**< slow clocks until the next move */
+  P1OUT &= ~GREEN_LED;		      /**< Green LED off until the next move */
+}
 
-u_int bgColor = COLOR_BLUE;     /**< The background color */
-int redrawScreen = 1;           /**< Boolean for whether screen needs to be redrawn */
+#ifdef PCSAMPLE
+/** Task: sends the PC-sampling histogram to the host (uartLib/pcsample.py) */
+void dumpStep(Task *task)
+{
+  uart_pcsample_dump();
+}
 
-Region fieldFence;		/**< fence around playing field  */
+Task dumpTask = { dumpStep, 3 };
+SoftTimer dumpTimer = { {0}, &dumpTask };
+#endif
 
 
 /** Initializes everything, enables interrupts and green LED, 
- *  and handles the rendering for the screen
+ *  then leaves motion and rendering to scheduled tasks
  */
 void main()
 {
@@ -167,10 +139,12 @@ void main()
   configureClocks();
   lcd_init();
   shapeInit();
+  abCircleInit();		/**< circles render & collide by chords */
   p2sw_init(1);
 
   shapeInit();
 
+  clockSetProfile(CLOCK_MAX_SPI);
   layerInit(&layer0);
   layerDraw(&layer0);
 
@@ -178,32 +152,15 @@ void main()
   layerGetBounds(&fieldLayer, &fieldFence);
 
 
-  enableWDTInterrupts();      /**< enable periodic interrupt */
-  or_sr(0x8);	              /**< GIE (enable interrupts) */
-
-
-  for(;;) { 
-    while (!redrawScreen) { /**< Pause CPU if screen doesn't need updating */
-      P1OUT &= ~GREEN_LED;    /**< Green led off witHo CPU */
-      or_sr(0x10);	      /**< CPU OFF */
-    }
-    P1OUT |= GREEN_LED;       /**< Green led on when CPU on */
-    redrawScreen = 0;
-    movLayerDraw(&ml0, &layer0);
-  }
-}
-
-/** Watchdog timer interrupt handler. 15 interrupts/sec */
-void wdt_c_handler()
-{
-  static short count = 0;
-  P1OUT |= GREEN_LED;		      /**< Green LED on when cpu on */
-  count ++;
-  if (count == 15) {
-    mlAdvance(&ml0, &fieldFence);
-    if (p2sw_read())
-      redrawScreen = 1;
-    count = 0;
-  } 
-  P1OUT &= ~GREEN_LED;		    /**< Green LED off when cpu off */
+  timebaseInit();
+  timerStart(&motionTimer, MOTION_PERIOD, MOTION_PERIOD);
+#if defined(PCSAMPLE) || defined(TELEMETRY)
+  uart_init();
+#endif
+#ifdef PCSAMPLE
+  pcSampleStart(997);		/**< ~2 kHz, prime to avoid aliasing */
+  timerStart(&dumpTimer, TIMEBASE_MS(10000), TIMEBASE_MS(10000));
+#endif
+  clockSetProfile(CLOCK_LOW_POWER);
+  schedRun();                 /**< runs tasks, sleeping when none are ready */
 }
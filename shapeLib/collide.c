@@ -0,0 +1,81 @@
+#include "shape.h"
+#include "collide.h"
+
+int
+sweepAdd(SweepList *list, MovLayer *ml)
+{
+  if (list->count >= list->capacity)
+    return 0;
+  list->entries[list->count++].ml = ml; /* sorted into place by sweepCollide */
+  return 1;
+}
+
+int
+sweepAddList(SweepList *list, MovLayer *ml)
+{
+  int missed = 0;
+  for (; ml; ml = ml->next)
+    if (!sweepAdd(list, ml))
+      missed++;
+  return missed;
+}
+
+void
+sweepRemove(SweepList *list, MovLayer *ml)
+{
+  u_char i;
+  for (i = 0; i < list->count; i++) {
+    if (list->entries[i].ml == ml) {
+      list->count--;
+      for (; i < list->count; i++) /* preserve order */
+	list->entries[i] = list->entries[i+1];
+      return;
+    }
+  }
+}
+
+/* insertion sort by left edge: nearly linear when nearly sorted */
+static void
+sweepSort(SweepList *list)
+{
+  SweepEntry *entries = list->entries;
+  u_char i, j;
+  for (i = 1; i < list->count; i++) {
+    int left = entries[i].bounds.topLeft.axes[0];
+    if (entries[i-1].bounds.topLeft.axes[0] <= left)
+      continue;			/* already in order */
+    SweepEntry e = entries[i];
+    for (j = i; j > 0 && entries[j-1].bounds.topLeft.axes[0] > left; j--)
+      entries[j] = entries[j-1];
+    entries[j] = e;
+  }
+}
+
+u_int
+sweepCollide(SweepList *list, CollisionHandler handler, void *arg)
+{
+  SweepEntry *entries = list->entries;
+  u_char i, j, count = list->count;
+  u_int pairs = 0;
+
+  for (i = 0; i < count; i++) {	/* bounds at next position */
+    Layer *l = entries[i].ml->layer;
+    abShapeGetBounds(l->abShape, &l->posNext, &entries[i].bounds);
+  }
+  sweepSort(list);
+
+  for (i = 0; i < count; i++) {
+    const Region *a = &entries[i].bounds;
+    int right = a->botRight.axes[0];
+    /* only layers starting left of a's right edge can overlap a */
+    for (j = i + 1; j < count && entries[j].bounds.topLeft.axes[0] <= right; j++) {
+      const Region *b = &entries[j].bounds;
+      if (a->topLeft.axes[1] <= b->botRight.axes[1] &&
+	  b->topLeft.axes[1] <= a->botRight.axes[1]) {
+	pairs++;
+	(*handler)(entries[i].ml, entries[j].ml, arg);
+      }
+    }
+  }
+  return pairs;
+}
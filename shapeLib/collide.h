@@ -0,0 +1,61 @@
+/** \file collide.h
+ *  \brief Broad-phase collision detection among moving layers.
+ */
+
+#ifndef collide_included
+#define collide_included
+
+#include "shape.h"
+
+/** A moving layer and its most recently computed bounding box
+ */
+typedef struct {
+  MovLayer *ml;
+  Region bounds;
+} SweepEntry;
+
+/** Moving layers sorted by the left edge of their bounding boxes.
+ *
+ *  The order is retained between frames.  Since objects move only a
+ *  little each frame, the list is nearly sorted and re-sorting it by
+ *  insertion sort is close to linear.
+ */
+typedef struct {
+  SweepEntry *entries;
+  u_char count, capacity;
+} SweepList;
+
+/** Defines a SweepList named name with room for capacity moving layers
+ */
+#define SWEEP_DEFINE(name, capacity)				\
+  SweepEntry name##_entries[capacity];				\
+  SweepList name = { name##_entries, 0, capacity }
+
+/** Called once for each pair of moving layers whose bounds overlap
+ */
+typedef void (*CollisionHandler)(MovLayer *a, MovLayer *b, void *arg);
+
+/** Adds ml to list.
+ *  \return 0 if list is full, otherwise 1
+ */
+int sweepAdd(SweepList *list, MovLayer *ml);
+
+/** Adds every moving layer in the linked list ml to list.
+ *  \return The number of layers that didn't fit
+ */
+int sweepAddList(SweepList *list, MovLayer *ml);
+
+/** Removes ml from list (if present)
+ */
+void sweepRemove(SweepList *list, MovLayer *ml);
+
+/** Sort-and-sweep over the layers' bounds at posNext.
+ *
+ *  Recomputes each layer's bounds, re-sorts the list by left edge, and
+ *  calls handler for every pair whose bounds overlap.
+ *
+ *  \return The number of overlapping pairs reported
+ */
+u_int sweepCollide(SweepList *list, CollisionHandler handler, void *arg);
+
+#endif // included
@@ -0,0 +1,102 @@
+#include "shape.h"
+
+typedef int (*SpansOp)(Span *out, const Span *a, int na, const Span *b, int nb);
+
+/* children's spans in row, combined by op; -1 if a child has no spans */
+static int
+csgRowSpans(const AbCsg *csg, const Vec2 *centerPos, int row, Span *spans, SpansOp op)
+{
+  Span spansA[ABSHAPE_MAX_SPANS], spansB[ABSHAPE_MAX_SPANS];
+  Vec2 posB;
+  int na, nb;
+  vec2Add(&posB, centerPos, &csg->bOffset);
+  na = abShapeRowSpans(csg->a, centerPos, row, spansA);
+  nb = abShapeRowSpans(csg->b, &posB, row, spansB);
+  if (na < 0 || nb < 0)
+    return -1;
+  return (*op)(spans, spansA, na, spansB, nb);
+}
+
+/* per-pixel checks of child a and child b */
+static int
+csgCheckA(const AbCsg *csg, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  return abShapeCheck(csg->a, centerPos, pixel);
+}
+
+static int
+csgCheckB(const AbCsg *csg, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  Vec2 posB;
+  vec2Add(&posB, centerPos, &csg->bOffset);
+  return abShapeCheck(csg->b, &posB, pixel);
+}
+
+static void
+csgBoundsB(const AbCsg *csg, const Vec2 *centerPos, Region *bounds)
+{
+  Vec2 posB;
+  vec2Add(&posB, centerPos, &csg->bOffset);
+  abShapeGetBounds(csg->b, &posB, bounds);
+}
+
+void
+abUnionGetBounds(const AbUnion *u, const Vec2 *centerPos, Region *bounds)
+{
+  Region boundsA, boundsB;
+  abShapeGetBounds(u->a, centerPos, &boundsA);
+  csgBoundsB(u, centerPos, &boundsB);
+  regionUnion(bounds, &boundsA, &boundsB);
+}
+
+int
+abUnionCheck(const AbUnion *u, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  return csgCheckA(u, centerPos, pixel) || csgCheckB(u, centerPos, pixel);
+}
+
+int
+abUnionRowSpans(const AbUnion *u, const Vec2 *centerPos, int row, Span *spans)
+{
+  return csgRowSpans(u, centerPos, row, spans, spansUnion);
+}
+
+void
+abIntersectGetBounds(const AbIntersect *i, const Vec2 *centerPos, Region *bounds)
+{
+  Region boundsA, boundsB;
+  abShapeGetBounds(i->a, centerPos, &boundsA);
+  csgBoundsB(i, centerPos, &boundsB);
+  vec2Max(&bounds->topLeft, &boundsA.topLeft, &boundsB.topLeft);
+  vec2Min(&bounds->botRight, &boundsA.botRight, &boundsB.botRight);
+}
+
+int
+abIntersectCheck(const AbIntersect *i, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  return csgCheckA(i, centerPos, pixel) && csgCheckB(i, centerPos, pixel);
+}
+
+int
+abIntersectRowSpans(const AbIntersect *i, const Vec2 *centerPos, int row, Span *spans)
+{
+  return csgRowSpans(i, centerPos, row, spans, spansIntersect);
+}
+
+void
+abDifferenceGetBounds(const AbDifference *d, const Vec2 *centerPos, Region *bounds)
+{
+  abShapeGetBounds(d->a, centerPos, bounds);
+}
+
+int
+abDifferenceCheck(const AbDifference *d, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  return csgCheckA(d, centerPos, pixel) && !csgCheckB(d, centerPos, pixel);
+}
+
+int
+abDifferenceRowSpans(const AbDifference *d, const Vec2 *centerPos, int row, Span *spans)
+{
+  return csgRowSpans(d, centerPos, row, spans, spansDifference);
+}
@@ -0,0 +1,78 @@
+#include "lcdutils.h"
+#include "lcddraw.h"
+#include "libTimer.h"
+#include "framestats.h"
+
+FrameStats frameStats;
+u_int frameChecks, frameRegions;
+
+void
+frameStatsEnd()
+{
+  static unsigned long lastEnd, lastIdle, lastIsr;
+  unsigned long now = timebaseNow(), idle = schedIdleTicks, isr;
+  CRIT_ENTER();
+  isr = isrTicks;		/* updated by interrupt handlers */
+  CRIT_EXIT();
+
+  frameStats.frame++;
+  frameStats.ticks = now - lastEnd;
+  frameStats.busyTicks = frameStats.ticks - (idle - lastIdle);
+  frameStats.isrTicks = isr - lastIsr;
+  lastEnd = now;
+  lastIdle = idle;
+  lastIsr = isr;
+
+  frameStats.pixels = lcdCounts.pixels;
+  frameStats.spiBytes = lcdCounts.spiBytes;
+  frameStats.setAreas = lcdCounts.setAreas;
+  lcdCounts.pixels = lcdCounts.spiBytes = 0;
+  lcdCounts.setAreas = 0;
+  frameStats.checks = frameChecks;
+  frameStats.regions = frameRegions;
+  frameChecks = frameRegions = 0;
+}
+
+#define OVERLAY_LEN 11		/* "NNNfps NNN%" */
+
+static char shown[OVERLAY_LEN];	/* as last drawn; 0 = must draw */
+
+/* writes v (< 1000) right-aligned in 3 chars */
+static void
+put3(char *s, u_int v)
+{
+  s[2] = '0' + v % 10;
+  v /= 10;
+  s[1] = v ? '0' + v % 10 : ' ';
+  v /= 10;
+  s[0] = v ? '0' + v : ' ';
+}
+
+void
+frameOverlayDraw(u_char col, u_char row, u_int fgColorBGR, u_int bgColorBGR)
+{
+  char text[OVERLAY_LEN];
+  unsigned long fps = 0, load = 0;
+  u_char i;
+  if (frameStats.ticks) {
+    fps = TIMEBASE_HZ / frameStats.ticks;
+    load = frameStats.busyTicks * 100 / frameStats.ticks;
+  }
+  put3(text, fps > 999 ? 999 : fps);
+  text[3] = 'f'; text[4] = 'p'; text[5] = 's'; text[6] = ' ';
+  put3(text + 7, load > 100 ? 100 : load);
+  text[10] = '%';
+  for (i = 0; i < OVERLAY_LEN; i++, col += 6)
+    if (text[i] != shown[i]) {	/* only what changed */
+      drawChar5x7(col, row, text[i], fgColorBGR, bgColorBGR);
+      shown[i] = text[i];
+    }
+}
+
+void
+frameOverlayInvalidate()
+{
+  u_char i;
+  for (i = 0; i < OVERLAY_LEN; i++)
+    shown[i] = 0;
+}
@@ -0,0 +1,53 @@
+/** \file framestats.h
+ *  \brief Per-frame work counters and an on-screen FPS/load overlay.
+ */
+
+#ifndef framestats_included
+#define framestats_included
+
+#include "shape.h"
+
+/** What the last frame cost.
+ *
+ *  Call frameStatsEnd() once per frame (e.g. after movLayerDraw).
+ *  Time and load are always measured; the work counters are counted
+ *  only when lcdLib and shapeLib are compiled with -DFRAME_STATS
+ *  ("make FRAME_STATS=1" from the top directory), and read 0 otherwise.
+ */
+typedef struct {
+  u_int frame;			/**< frames ended so far */
+  unsigned long pixels;		/**< colors written to the LCD */
+  unsigned long spiBytes;	/**< bytes sent to the LCD */
+  u_int setAreas;		/**< lcd_setArea calls */
+  u_int checks;			/**< abShapeCheck calls */
+  u_int regions;		/**< regions redrawn by layerDrawRegion */
+  unsigned long ticks;		/**< timebase ticks since the previous frame */
+  unsigned long busyTicks;	/**< of which the CPU was awake (not in schedRun's LPM) */
+  unsigned long isrTicks;	/**< of which in timed interrupt handlers (see timebase.h) */
+} FrameStats;
+
+extern FrameStats frameStats;	/**< the last complete frame */
+
+/** Counters of the frame in progress */
+extern u_int frameChecks, frameRegions;
+
+#ifdef FRAME_STATS
+#define FRAME_COUNT(counter) ((counter)++)
+#else
+#define FRAME_COUNT(counter) ((void)0)
+#endif
+
+/** Ends a frame: moves the current counts into frameStats and clears them */
+void frameStatsEnd();
+
+/** Draws "NNNfps NNN%" (frames per second and CPU load of the last
+ *  frame) with drawString5x7, redrawing only the characters that
+ *  changed since the previous call.  Place it where layers don't
+ *  draw, or call frameOverlayInvalidate() after they do.
+ */
+void frameOverlayDraw(u_char col, u_char row, u_int fgColorBGR, u_int bgColorBGR);
+
+/** Makes the next frameOverlayDraw redraw every character */
+void frameOverlayInvalidate();
+
+#endif // included
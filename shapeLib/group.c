@@ -0,0 +1,71 @@
+#include "shape.h"
+
+void
+abGroupInit(AbGroup *group)
+{
+  Layer *child;
+  Region childBounds;
+  Vec2 childPos;
+  int first = 1;
+  group->extent.topLeft = group->extent.botRight = vec2Zero;
+  for (child = group->children; child; child = child->next) {
+    /* measured about screenCenter since some shapes clip to the screen */
+    vec2Add(&childPos, &screenCenter, &child->pos);
+    abShapeGetBounds(child->abShape, &childPos, &childBounds);
+    vec2Sub(&childBounds.topLeft, &childBounds.topLeft, &screenCenter);
+    vec2Sub(&childBounds.botRight, &childBounds.botRight, &screenCenter);
+    if (first)
+      group->extent = childBounds;
+    else
+      regionUnion(&group->extent, &group->extent, &childBounds);
+    first = 0;
+  }
+}
+
+void
+abGroupGetBounds(const AbGroup *group, const Vec2 *centerPos, Region *bounds)
+{
+  vec2Add(&bounds->topLeft, centerPos, &group->extent.topLeft);
+  vec2Add(&bounds->botRight, centerPos, &group->extent.botRight);
+}
+
+int
+abGroupCheck(const AbGroup *group, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  Region bounds;
+  Vec2 relPos;
+  const Layer *child;
+  abGroupGetBounds(group, centerPos, &bounds);
+  if (pixel->axes[0] < bounds.topLeft.axes[0] || pixel->axes[0] > bounds.botRight.axes[0] ||
+      pixel->axes[1] < bounds.topLeft.axes[1] || pixel->axes[1] > bounds.botRight.axes[1])
+    return 0;			/* outside every child */
+  vec2Sub(&relPos, pixel, centerPos);
+  for (child = group->children; child; child = child->next)
+    if (abShapeCheck(child->abShape, &child->pos, &relPos))
+      return 1;
+  return 0;
+}
+
+int
+abGroupRowSpans(const AbGroup *group, const Vec2 *centerPos, int row, Span *spans)
+{
+  Span childSpans[ABSHAPE_MAX_SPANS], merged[ABSHAPE_MAX_SPANS];
+  const Layer *child;
+  int n = 0, nChild, i;
+  if (row < centerPos->axes[1] + group->extent.topLeft.axes[1] ||
+      row > centerPos->axes[1] + group->extent.botRight.axes[1])
+    return 0;
+  for (child = group->children; child; child = child->next) {
+    Vec2 childPos;
+    vec2Add(&childPos, centerPos, &child->pos);
+    nChild = abShapeRowSpans(child->abShape, &childPos, row, childSpans);
+    if (nChild < 0)
+      return -1;
+    n = spansUnion(merged, spans, n, childSpans, nChild);
+    if (n < 0)
+      return -1;
+    for (i = 0; i < n; i++)
+      spans[i] = merged[i];
+  }
+  return n;
+}
@@ -1,29 +1,176 @@
 #include "lcdutils.h"
 #include "lcddraw.h"
 #include "shape.h"
+#include "profile.h"
+#include "framestats.h"
+
+/* one row being composited: disjoint runs sorted by col, each with the
+   color of the topmost layer covering it */
+typedef struct {
+  u_char n;
+  Span runs[LAYER_ROW_RUNS];
+  u_int colors[LAYER_ROW_RUNS];
+} RowRuns;
+
+/* paints color over the parts of colStart..colEnd not yet painted by
+   a layer above; -1 if the row has too many runs */
+static int
+rowPaint(RowRuns *r, int colStart, int colEnd, u_int color)
+{
+  u_char i = 0, j;
+  while (colStart <= colEnd) {
+    int gapEnd = colEnd;
+    while (i < r->n && r->runs[i].colEnd < colStart)
+      i++;			/* skip runs left of colStart */
+    if (i < r->n && r->runs[i].colStart - 1 < gapEnd)
+      gapEnd = r->runs[i].colStart - 1;
+    if (colStart <= gapEnd) {	/* unpainted: insert a run at i */
+      if (r->n == LAYER_ROW_RUNS)
+	return -1;
+      for (j = r->n; j > i; j--) {
+	r->runs[j] = r->runs[j-1];
+	r->colors[j] = r->colors[j-1];
+      }
+      r->runs[i].colStart = colStart;
+      r->runs[i].colEnd = gapEnd;
+      r->colors[i] = color;
+      r->n++;
+      i++;
+      if (i == r->n)
+	break;
+    }
+    colStart = r->runs[i].colEnd + 1; /* resume right of run i */
+    i++;
+  }
+  return 0;
+}
+
+/* paints row with layers (positioned relative to offset), top to
+   bottom; -1 if some layer lacks row spans or the row has too many runs */
+static int
+rowPaintLayers(RowRuns *r, const Layer *layers, const Vec2 *offset,
+	       int row, const Region *area)
+{
+  Span spans[ABSHAPE_MAX_SPANS];
+  const Layer *l;
+  for (l = layers; l; l = l->next) {
+    const AbShape *s = l->abShape;
+    Vec2 pos;
+    int n, i;
+    vec2Add(&pos, &l->pos, offset);
+    if (s->check == (AbCheckFn)abGroupCheck) { /* paint children */
+      const AbGroup *group = (const AbGroup *)s;
+      if (row < pos.axes[1] + group->extent.topLeft.axes[1] ||
+	  row > pos.axes[1] + group->extent.botRight.axes[1])
+	continue;
+      if (rowPaintLayers(r, group->children, &pos, row, area) < 0)
+	return -1;
+      continue;
+    }
+    n = abShapeRowSpans(s, &pos, row, spans);
+    if (n < 0)
+      return -1;
+    for (i = 0; i < n; i++) {
+      int colStart = spans[i].colStart, colEnd = spans[i].colEnd;
+      if (colStart < area->topLeft.axes[0])
+	colStart = area->topLeft.axes[0];
+      if (colEnd > area->botRight.axes[0])
+	colEnd = area->botRight.axes[0];
+      if (colStart <= colEnd && rowPaint(r, colStart, colEnd, l->color) < 0)
+	return -1;
+    }
+  }
+  return 0;
+}
 
 void
-layerDraw(Layer *layers)
+layerDrawRegion(const Layer *layers, const Region *area)
 {
+  Region clip = *area;
+  RowRuns r;
   int row, col;
-  for (row = 0; row < screenHeight; row++) {
-    lcd_setArea(0, row, screenWidth-1, row);
-    for (col = 0; col < screenWidth; col++) {
-      Vec2 pixelPos = {col, row};
-      u_int color = bgColor;
-      Layer *probeLayer;
-      for (probeLayer = layers; probeLayer; probeLayer = probeLayer->next) {
-	if (abShapeCheck(probeLayer->abShape, &probeLayer->pos, &pixelPos)) {
-	  color = probeLayer->color;
-	  break; 
-	} /* if check */
-      } // for checking all layers at col, row
-      lcd_writeColor(color); 
-    } // for col
-  } // for row
+  u_char i;
+  if (clip.topLeft.axes[0] < 0) clip.topLeft.axes[0] = 0; /* clip once */
+  if (clip.topLeft.axes[1] < 0) clip.topLeft.axes[1] = 0;
+  if (clip.botRight.axes[0] > screenWidth - 1) clip.botRight.axes[0] = screenWidth - 1;
+  if (clip.botRight.axes[1] > screenHeight - 1) clip.botRight.axes[1] = screenHeight - 1;
+  if (clip.topLeft.axes[0] > clip.botRight.axes[0] ||
+      clip.topLeft.axes[1] > clip.botRight.axes[1])
+    return;			/* off screen */
+
+  FRAME_COUNT(frameRegions);
+  lcd_setArea(clip.topLeft.axes[0], clip.topLeft.axes[1],
+	      clip.botRight.axes[0], clip.botRight.axes[1]);
+  for (row = clip.topLeft.axes[1]; row <= clip.botRight.axes[1]; row++) {
+    r.n = 0;
+    if (rowPaintLayers(&r, layers, &vec2Zero, row, &clip) < 0) {
+      Vec2 pixelPos;		/* fall back to probing each pixel */
+      pixelPos.axes[1] = row;
+      for (pixelPos.axes[0] = clip.topLeft.axes[0];
+	   pixelPos.axes[0] <= clip.botRight.axes[0]; pixelPos.axes[0]++)
+	lcd_writeColor(layerProbe(layers, &pixelPos));
+      continue;
+    }
+    col = clip.topLeft.axes[0];	/* emit runs, filling gaps with bgColor */
+    for (i = 0; i < r.n; i++) {
+      if (r.runs[i].colStart > col)
+	lcd_writeColorRun(bgColor, r.runs[i].colStart - col);
+      lcd_writeColorRun(r.colors[i], r.runs[i].colEnd - r.runs[i].colStart + 1);
+      col = r.runs[i].colEnd + 1;
+    }
+    if (col <= clip.botRight.axes[0])
+      lcd_writeColorRun(bgColor, clip.botRight.axes[0] - col + 1);
+  }
+}
+
+void
+layerDraw(Layer *layers)
+{
+  Region screen;
+  PROFILE_BEGIN(PROFILE_LAYER_DRAW);
+  screen.topLeft = vec2Zero;
+  screen.botRight.axes[0] = screenWidth - 1;
+  screen.botRight.axes[1] = screenHeight - 1;
+  layerDrawRegion(layers, &screen);
+  PROFILE_END(PROFILE_LAYER_DRAW);
 } 
 
 
+/* searches layers for pixelPos; true if found, setting *color */
+static int
+layerProbeColor(const Layer *layers, const Vec2 *pixelPos, u_int *color)
+{
+  const Layer *probeLayer;
+  for (probeLayer = layers; probeLayer; probeLayer = probeLayer->next) {
+    const AbShape *s = probeLayer->abShape;
+    if (s->check == (AbCheckFn)abGroupCheck) { /* search children */
+      const AbGroup *group = (const AbGroup *)s;
+      Region bounds;
+      Vec2 relPos;
+      abGroupGetBounds(group, &probeLayer->pos, &bounds);
+      if (pixelPos->axes[0] < bounds.topLeft.axes[0] ||
+	  pixelPos->axes[0] > bounds.botRight.axes[0] ||
+	  pixelPos->axes[1] < bounds.topLeft.axes[1] ||
+	  pixelPos->axes[1] > bounds.botRight.axes[1])
+	continue;		/* whole group rejected */
+      vec2Sub(&relPos, pixelPos, &probeLayer->pos);
+      if (layerProbeColor(group->children, &relPos, color))
+	return 1;
+    } else if (abShapeCheck(s, &probeLayer->pos, pixelPos)) {
+      *color = probeLayer->color;
+      return 1;
+    }
+  } // for checking all layers at pixelPos
+  return 0;
+}
+
+u_int
+layerProbe(const Layer *layers, const Vec2 *pixelPos)
+{
+  u_int color = bgColor;
+  layerProbeColor(layers, pixelPos, &color);
+  return color;
+}
 
 void
 layerGetBounds(const Layer *l, Region *bounds)
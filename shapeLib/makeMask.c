@@ -0,0 +1,120 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "assert.h"
+#include "pnm.h"
+
+// Generate an AbMask from a PBM/PGM/PPM image
+//
+// usage: makeMask [-i] name image
+//   writes name.c (bitmap, row tables & AbMask) and name.h
+//   dark pixels are set (light pixels with -i)
+//   the mask is cropped to its set pixels and centered on them
+int main(int argc, char **argv)
+{
+  PnmImage image;
+  int invert = 0, row, col;
+  int top, bot, left, right, width, height, rowShift = 0;
+  char filename[200];
+  FILE *fp;
+  const char *name;
+
+  if (argc > 1 && !strcmp(argv[1], "-i")) {
+    invert = 1;
+    argc--, argv++;
+  }
+  if (argc != 3) {
+    fprintf(stderr, "usage: makeMask [-i] name image.pbm\n");
+    return 1;
+  }
+  name = argv[1];
+  pnmRead(&image, argv[2]);
+
+  // set[row*w+col]: dark (or light if inverted)
+  unsigned char *set = malloc(image.width * image.height);
+  assert(set);
+  top = image.height, bot = -1, left = image.width, right = -1;
+  for (row = 0; row < image.height; row++)
+    for (col = 0; col < image.width; col++) {
+      unsigned char *p = image.rgb + 3 * (row * image.width + col);
+      int dark = (p[0] + p[1] + p[2]) < 3 * 128;
+      int s = set[row * image.width + col] = dark ^ invert;
+      if (s) {
+	if (row < top) top = row;
+	if (row > bot) bot = row;
+	if (col < left) left = col;
+	if (col > right) right = col;
+      }
+    }
+  if (bot < 0) {
+    fprintf(stderr, "%s: no pixels set\n", argv[2]);
+    return 1;
+  }
+  width = right - left + 1, height = bot - top + 1;
+  if (width > 255 || height > 255) {
+    fprintf(stderr, "%s: mask larger than 255x255\n", argv[2]);
+    return 1;
+  }
+  while ((1 << rowShift) * 8 < width)	/* row stride is a power of 2 */
+    rowShift++;
+
+  sprintf(filename, "%s.h", name);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeMask from %s\n", argv[2]);
+  fprintf(fp, "#ifndef %s_included\n#define %s_included\n\n", name, name);
+  fprintf(fp, "#include \"shape.h\"\n\n");
+  fprintf(fp, "extern const AbMask %s;\t/* %dx%d */\n", name, width, height);
+  fprintf(fp, "\n#endif // included\n");
+  fclose(fp);
+
+  sprintf(filename, "%s.c", name);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeMask from %s\n", argv[2]);
+  fprintf(fp, "#include \"%s.h\"\n\n", name);
+
+  fprintf(fp, "static const unsigned char %s_bits[%d] = {\n", name, height << rowShift);
+  for (row = top; row <= bot; row++) {
+    int byteIndex;
+    fprintf(fp, "   ");
+    for (byteIndex = 0; byteIndex < (1 << rowShift); byteIndex++) {
+      int byte = 0, bit;
+      for (bit = 0; bit < 8; bit++) {
+	col = left + byteIndex * 8 + bit;
+	if (col <= right && set[row * image.width + col])
+	  byte |= 0x80 >> bit;
+      }
+      fprintf(fp, " 0x%02x,", byte);
+    }
+    fprintf(fp, " // row %d\n", row - top);
+  }
+  fprintf(fp, "};\n\n");
+
+  {				/* first & last set column per row */
+    int first[256], last[256];
+    for (row = top; row <= bot; row++) {
+      first[row - top] = 255, last[row - top] = 0; /* empty row */
+      for (col = left; col <= right; col++)
+	if (set[row * image.width + col]) {
+	  if (first[row - top] == 255)
+	    first[row - top] = col - left;
+	  last[row - top] = col - left;
+	}
+    }
+    fprintf(fp, "static const unsigned char %s_rowFirst[%d] = {", name, height);
+    for (row = 0; row < height; row++)
+      fprintf(fp, "%s%d,", (row % 16) ? " " : "\n    ", first[row]);
+    fprintf(fp, "\n};\n\n");
+    fprintf(fp, "static const unsigned char %s_rowLast[%d] = {", name, height);
+    for (row = 0; row < height; row++)
+      fprintf(fp, "%s%d,", (row % 16) ? " " : "\n    ", last[row]);
+    fprintf(fp, "\n};\n\n");
+  }
+
+  fprintf(fp, "const AbMask %s = {\n", name);
+  fprintf(fp, "  abMaskGetBounds, abMaskCheck, %d, %d, %d,\n", width, height, rowShift);
+  fprintf(fp, "  %s_bits, %s_rowFirst, %s_rowLast\n};\n", name, name, name);
+  fclose(fp);
+  return 0;
+}
@@ -0,0 +1,236 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "string.h"
+#include "assert.h"
+#include "pnm.h"
+
+// Generate a run-length encoded Sprite from a PPM (or PGM/PBM) image
+//
+// usage: makeSprite [-t rrggbb] name image [image...]
+//   writes name.c (palette, runs & Sprite) and name.h
+//   pixels of the transparent color (default ff00ff, magenta) are
+//   palette index 0 and show what's beneath the sprite
+//   given several images (the frames of an animation, all the same
+//   size), name is a SpriteAnim that also holds the spans that change
+//   between consecutive frames
+
+#define MAX_COLORS 255
+#define MAX_FRAMES 64
+
+// unchanged gaps shorter than this are redrawn rather than paying
+// for another lcd_setArea (which costs about as much as 5 pixels)
+#define MIN_GAP 5
+
+static unsigned int palette[MAX_COLORS + 1];
+static int nColors = 1;		/* index 0 is transparent */
+static unsigned int transparentRGB = 0xff00ff;
+
+// 8-bit RGB to the LCD's 16-bit BGR (5 blue, 6 green, 5 red)
+static unsigned int
+rgbToBGR(const unsigned char *p)
+{
+  return ((p[2] >> 3) << 11) | ((p[1] >> 2) << 5) | (p[0] >> 3);
+}
+
+// palette index of pixel p, adding its color if new
+static int
+colorIndex(const unsigned char *p)
+{
+  unsigned int rgb = (p[0] << 16) | (p[1] << 8) | p[2], bgr;
+  int i;
+  if (rgb == transparentRGB)
+    return 0;
+  bgr = rgbToBGR(p);
+  for (i = 1; i < nColors; i++)
+    if (palette[i] == bgr)
+      return i;
+  if (nColors > MAX_COLORS) {
+    fprintf(stderr, "makeSprite: more than %d colors\n", MAX_COLORS);
+    exit(1);
+  }
+  palette[nColors] = bgr;
+  return nColors++;
+}
+
+// writes the runs & row table of one frame as name_runs<suffix> &
+// name_rowStart<suffix>; returns the frame's palette indices
+static unsigned char *
+writeFrame(FILE *fp, const char *name, const char *suffix, const PnmImage *image)
+{
+  unsigned char *indices = malloc(image->width * image->height);
+  int row, col, nRuns = 0;
+  assert(indices);
+  for (row = 0; row < image->height; row++)
+    for (col = 0; col < image->width; col++)
+      indices[row * image->width + col] =
+	colorIndex(image->rgb + 3 * (row * image->width + col));
+
+  fprintf(fp, "static const unsigned char %s_runs%s[] = { // length, color\n", name, suffix);
+  int *rowStart = malloc(image->height * sizeof(int));
+  assert(rowStart);
+  for (row = 0; row < image->height; row++) {
+    const unsigned char *rowIndices = indices + row * image->width;
+    rowStart[row] = 2 * nRuns;
+    fprintf(fp, "   ");
+    for (col = 0; col < image->width; ) {
+      int index = rowIndices[col], length = 0;
+      while (col < image->width && length < 255 && rowIndices[col] == index) {
+	col++;
+	length++;
+      }
+      fprintf(fp, " %d,%d,", length, index);
+      nRuns++;
+    }
+    fprintf(fp, " // row %d\n", row);
+  }
+  fprintf(fp, "};\n\n");
+
+  fprintf(fp, "static const unsigned int %s_rowStart%s[%d] = {", name, suffix, image->height);
+  for (row = 0; row < image->height; row++)
+    fprintf(fp, "%s%d,", (row % 12) ? " " : "\n   ", rowStart[row]);
+  fprintf(fp, "\n};\n\n");
+  free(rowStart);
+  return indices;
+}
+
+// writes the spans of to that differ from from as row,col,count
+// triples; returns the number of bytes written
+static int
+writeDiff(FILE *fp, const unsigned char *from, const unsigned char *to,
+	  int width, int height)
+{
+  int row, col, nBytes = 0;
+  for (row = 0; row < height; row++) {
+    const unsigned char *a = from + row * width, *b = to + row * width;
+    for (col = 0; col < width; ) {
+      int start, end, gap;
+      if (a[col] == b[col]) {
+	col++;
+	continue;
+      }
+      start = end = col;	/* extend over changes & short gaps */
+      for (col++, gap = 0; col < width && gap < MIN_GAP; col++) {
+	if (a[col] != b[col]) {
+	  end = col;
+	  gap = 0;
+	} else {
+	  gap++;
+	}
+      }
+      col = end + 1;
+      fprintf(fp, " %d,%d,%d,", row, start, end - start + 1);
+      nBytes += 3;
+    }
+  }
+  fprintf(fp, " 255,\n");
+  return nBytes + 1;
+}
+
+int main(int argc, char **argv)
+{
+  PnmImage images[MAX_FRAMES];
+  unsigned char *indices[MAX_FRAMES];
+  char filename[200], suffix[8];
+  const char *name;
+  FILE *fp;
+  int frame, nFrames, col;
+
+  if (argc > 2 && !strcmp(argv[1], "-t")) {
+    transparentRGB = strtol(argv[2], 0, 16);
+    argc -= 2, argv += 2;
+  }
+  if (argc < 3) {
+    fprintf(stderr, "usage: makeSprite [-t rrggbb] name image.ppm [image.ppm...]\n");
+    return 1;
+  }
+  name = argv[1];
+  nFrames = argc - 2;
+  if (nFrames > MAX_FRAMES) {
+    fprintf(stderr, "makeSprite: more than %d frames\n", MAX_FRAMES);
+    return 1;
+  }
+  for (frame = 0; frame < nFrames; frame++) {
+    pnmRead(&images[frame], argv[frame + 2]);
+    if (images[frame].width > 255 || images[frame].height > 254) {
+      fprintf(stderr, "%s: sprite larger than 255x254\n", argv[frame + 2]);
+      return 1;
+    }
+    if (images[frame].width != images[0].width ||
+	images[frame].height != images[0].height) {
+      fprintf(stderr, "%s: frames differ in size\n", argv[frame + 2]);
+      return 1;
+    }
+  }
+  const PnmImage *image = &images[0];
+
+  sprintf(filename, "%s.h", name);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeSprite from %s%s\n", argv[2],
+	  nFrames > 1 ? "..." : "");
+  fprintf(fp, "#ifndef %s_included\n#define %s_included\n\n", name, name);
+  fprintf(fp, "#include \"sprite.h\"\n\n");
+  if (nFrames > 1)
+    fprintf(fp, "extern const SpriteAnim %s;\t/* %d frames, %dx%d */\n",
+	    name, nFrames, image->width, image->height);
+  else
+    fprintf(fp, "extern const Sprite %s;\t/* %dx%d */\n", name, image->width, image->height);
+  fprintf(fp, "\n#endif // included\n");
+  fclose(fp);
+
+  sprintf(filename, "%s.c", name);
+  fp = fopen(filename, "w");
+  assert(fp);
+  fprintf(fp, "// Automatically generated by makeSprite from %s%s\n", argv[2],
+	  nFrames > 1 ? "..." : "");
+  fprintf(fp, "#include \"%s.h\"\n\n", name);
+
+  for (frame = 0; frame < nFrames; frame++) {
+    if (nFrames > 1)
+      sprintf(suffix, "%d", frame);
+    else
+      suffix[0] = 0;
+    fprintf(fp, "// %s\n", argv[frame + 2]);
+    indices[frame] = writeFrame(fp, name, suffix, &images[frame]);
+  }
+
+  fprintf(fp, "static const unsigned int %s_palette[%d] = {", name, nColors);
+  for (col = 0; col < nColors; col++)
+    fprintf(fp, "%s0x%04x,", (col % 8) ? " " : "\n   ", palette[col]);
+  fprintf(fp, "\n};\n\n");
+
+  if (nFrames == 1) {
+    fprintf(fp, "const Sprite %s = {\n", name);
+    fprintf(fp, "  %d, %d, 0, %s_palette, %s_runs, %s_rowStart\n};\n",
+	    image->width, image->height, name, name, name);
+    fclose(fp);
+    return 0;
+  }
+
+  fprintf(fp, "static const Sprite %s_frames[%d] = {\n", name, nFrames);
+  for (frame = 0; frame < nFrames; frame++)
+    fprintf(fp, "  { %d, %d, 0, %s_palette, %s_runs%d, %s_rowStart%d },\n",
+	    image->width, image->height, name, name, frame, name, frame);
+  fprintf(fp, "};\n\n");
+
+  int diffStart[MAX_FRAMES], nBytes = 0;
+  fprintf(fp, "static const unsigned char %s_diffs[] = { // row, col, count\n", name);
+  for (frame = 0; frame < nFrames; frame++) {
+    diffStart[frame] = nBytes;
+    fprintf(fp, "    // frame %d -> %d\n   ", frame, (frame + 1) % nFrames);
+    nBytes += writeDiff(fp, indices[frame], indices[(frame + 1) % nFrames],
+			image->width, image->height);
+  }
+  fprintf(fp, "};\n\n");
+
+  fprintf(fp, "static const unsigned int %s_diffStart[%d] = {", name, nFrames);
+  for (frame = 0; frame < nFrames; frame++)
+    fprintf(fp, "%s%d,", (frame % 12) ? " " : "\n   ", diffStart[frame]);
+  fprintf(fp, "\n};\n\n");
+
+  fprintf(fp, "const SpriteAnim %s = {\n", name);
+  fprintf(fp, "  %d, %s_frames, %s_diffs, %s_diffStart\n};\n",
+	  nFrames, name, name, name);
+  fclose(fp);
+  return 0;
+}
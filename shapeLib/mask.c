@@ -0,0 +1,50 @@
+#include "shape.h"
+
+void
+abMaskGetBounds(const AbMask *mask, const Vec2 *centerPos, Region *bounds)
+{
+  bounds->topLeft.axes[0] = centerPos->axes[0] - (mask->width >> 1);
+  bounds->topLeft.axes[1] = centerPos->axes[1] - (mask->height >> 1);
+  bounds->botRight.axes[0] = bounds->topLeft.axes[0] + mask->width - 1;
+  bounds->botRight.axes[1] = bounds->topLeft.axes[1] + mask->height - 1;
+}
+
+int
+abMaskCheck(const AbMask *mask, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  int col = pixel->axes[0] - centerPos->axes[0] + (mask->width >> 1);
+  int row = pixel->axes[1] - centerPos->axes[1] + (mask->height >> 1);
+  if (row < 0 || row >= mask->height)
+    return 0;
+  if (col < mask->rowFirst[row] || col > mask->rowLast[row])
+    return 0;			/* also rejects empty rows */
+  return (mask->bits[(row << mask->rowShift) + (col >> 3)] & (0x80 >> (col & 7))) != 0;
+}
+
+int
+abMaskRowSpans(const AbMask *mask, const Vec2 *centerPos, int row, Span *spans)
+{
+  int left = centerPos->axes[0] - (mask->width >> 1);
+  int col, last, n = 0, inRun = 0;
+  const u_char *rowBits;
+  row = row - centerPos->axes[1] + (mask->height >> 1);
+  if (row < 0 || row >= mask->height)
+    return 0;
+  col = mask->rowFirst[row], last = mask->rowLast[row];
+  rowBits = mask->bits + (row << mask->rowShift);
+  for (; col <= last; col++) {
+    int set = rowBits[col >> 3] & (0x80 >> (col & 7));
+    if (set && !inRun) {	/* run starts */
+      if (n == ABSHAPE_MAX_SPANS)
+	return -1;		/* too many runs: use check */
+      spans[n].colStart = left + col;
+      inRun = 1;
+    } else if (!set && inRun) {	/* run ended at col-1 */
+      spans[n++].colEnd = left + col - 1;
+      inRun = 0;
+    }
+  }
+  if (inRun)
+    spans[n++].colEnd = left + last;
+  return n;
+}
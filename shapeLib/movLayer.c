@@ -0,0 +1,79 @@
+#include "lcdutils.h"
+#include "shape.h"
+#include "profile.h"
+
+void
+movLayerAdvance(MovLayer *ml, const Region *fence)
+{
+  Vec2 newPos;
+  u_char axis;
+  Region shapeBoundary;
+  vec2Add(&newPos, &ml->layer->posNext, &ml->velocity);
+  abShapeGetBounds(ml->layer->abShape, &newPos, &shapeBoundary);
+  for (axis = 0; axis < 2; axis ++) {
+    if ((shapeBoundary.topLeft.axes[axis] < fence->topLeft.axes[axis]) ||
+	(shapeBoundary.botRight.axes[axis] > fence->botRight.axes[axis]) ) {
+      int velocity = ml->velocity.axes[axis] = -ml->velocity.axes[axis];
+      newPos.axes[axis] += (2*velocity);
+    }	/* if outside of fence */
+  } /* for axis */
+  ml->layer->posNext = newPos;
+}
+
+volatile u_int mlSeq;
+
+/* keeps the compiler from moving loads of posNext across reads of mlSeq */
+#define MEMORY_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+void
+mlPublish()
+{
+  MEMORY_BARRIER();
+  mlSeq++;
+}
+
+void
+mlAdvance(MovLayer *ml, const Region *fence)
+{
+  PROFILE_BEGIN(PROFILE_ML_ADVANCE);
+  for (; ml; ml = ml->next) {
+    if (ml->countdown > 1) {	/* not this time */
+      ml->countdown--;
+      continue;
+    }
+    ml->countdown = ml->period;
+    movLayerAdvance(ml, fence);
+  } /* for ml */
+  mlPublish();
+  PROFILE_END(PROFILE_ML_ADVANCE);
+}
+
+void
+movLayerDraw(MovLayer *movLayers, Layer *layers)
+{
+  MovLayer *movLayer;
+
+  u_int seq;
+
+  PROFILE_BEGIN(PROFILE_MOVLAYER_DRAW);
+  for (movLayer = movLayers; movLayer; movLayer = movLayer->next)
+    movLayer->layer->posLast = movLayer->layer->pos;
+  do {				/* snapshot posNext; retry if a frame was published meanwhile */
+    seq = mlSeq;
+    MEMORY_BARRIER();
+    for (movLayer = movLayers; movLayer; movLayer = movLayer->next)
+      movLayer->layer->pos = movLayer->layer->posNext;
+    MEMORY_BARRIER();
+  } while (seq != mlSeq);
+
+  for (movLayer = movLayers; movLayer; movLayer = movLayer->next) { /* for each moving layer */
+    Region bounds;
+    Layer *l = movLayer->layer;
+    if (l->pos.axes[0] == l->posLast.axes[0] &&
+	l->pos.axes[1] == l->posLast.axes[1])
+      continue;			/* didn't move: nothing to redraw */
+    layerGetBounds(l, &bounds);
+    layerDrawRegion(layers, &bounds);
+  } // for moving layer being updated
+  PROFILE_END(PROFILE_MOVLAYER_DRAW);
+}
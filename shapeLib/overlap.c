@@ -0,0 +1,78 @@
+#include "shape.h"
+
+/* true if col is within one of n spans */
+static int
+spansContain(const Span *spans, int n, int col)
+{
+  for (; n > 0; n--, spans++)
+    if (col >= spans->colStart && col <= spans->colEnd)
+      return 1;
+  return 0;
+}
+
+/* true if shape covers (col,row); uses spans when n >= 0 */
+static int
+covers(const AbShape *s, const Vec2 *pos, const Span *spans, int n, int col, int row)
+{
+  if (n >= 0)
+    return spansContain(spans, n, col);
+  Vec2 pixel = {col, row};
+  return abShapeCheck(s, pos, &pixel);
+}
+
+int
+abShapeOverlap(const AbShape *a, const Vec2 *posA,
+	       const AbShape *b, const Vec2 *posB, Vec2 *contact)
+{
+  Region boundsA, boundsB, both;
+  Span spansA[ABSHAPE_MAX_SPANS], spansB[ABSHAPE_MAX_SPANS];
+  int row, col;
+
+  abShapeGetBounds(a, posA, &boundsA);
+  abShapeGetBounds(b, posB, &boundsB);
+  vec2Max(&both.topLeft, &boundsA.topLeft, &boundsB.topLeft);
+  vec2Min(&both.botRight, &boundsA.botRight, &boundsB.botRight);
+
+  for (row = both.topLeft.axes[1]; row <= both.botRight.axes[1]; row++) {
+    int nA = abShapeRowSpans(a, posA, row, spansA);
+    int nB = abShapeRowSpans(b, posB, row, spansB);
+    if (nA == 0 || nB == 0)
+      continue;			/* a shape misses this row */
+    if (nA > 0 && nB > 0) {	/* merge the sorted span lists */
+      int iA = 0, iB = 0;
+      while (iA < nA && iB < nB) {
+	int start = spansA[iA].colStart > spansB[iB].colStart ?
+	  spansA[iA].colStart : spansB[iB].colStart;
+	int end = spansA[iA].colEnd < spansB[iB].colEnd ?
+	  spansA[iA].colEnd : spansB[iB].colEnd;
+	if (start < both.topLeft.axes[0])
+	  start = both.topLeft.axes[0];
+	if (end > both.botRight.axes[0])
+	  end = both.botRight.axes[0];
+	if (start <= end) {
+	  if (contact) {
+	    contact->axes[0] = start;
+	    contact->axes[1] = row;
+	  }
+	  return 1;
+	}
+	if (spansA[iA].colEnd < spansB[iB].colEnd) /* advance the span that ends first */
+	  iA++;
+	else
+	  iB++;
+      }
+    } else {			/* at least one shape needs per-pixel checks */
+      for (col = both.topLeft.axes[0]; col <= both.botRight.axes[0]; col++) {
+	if (covers(a, posA, spansA, nA, col, row) &&
+	    covers(b, posB, spansB, nB, col, row)) {
+	  if (contact) {
+	    contact->axes[0] = col;
+	    contact->axes[1] = row;
+	  }
+	  return 1;
+	}
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,96 @@
+// Netpbm image reader for host-side generators (makeMask, makeSprite)
+#include "stdio.h"
+#include "stdlib.h"
+#include "ctype.h"
+#include "pnm.h"
+
+static void
+fail(const char *filename, const char *why)
+{
+  fprintf(stderr, "%s: %s\n", filename, why);
+  exit(1);
+}
+
+// reads an ascii integer, skipping whitespace and # comments
+static int
+readInt(FILE *fp, const char *filename)
+{
+  int c, val = 0, digits = 0;
+  while ((c = getc(fp)) != EOF) {
+    if (c == '#')
+      while ((c = getc(fp)) != EOF && c != '\n')
+	;
+    else if (!isspace(c))
+      break;
+  }
+  while (c != EOF && isdigit(c)) {
+    val = val * 10 + (c - '0');
+    digits++;
+    c = getc(fp);
+  }
+  if (!digits)
+    fail(filename, "bad header or plain data");
+  return val;
+}
+
+void
+pnmRead(PnmImage *image, const char *filename)
+{
+  FILE *fp = fopen(filename, "rb");
+  int kind, maxval = 1, i, n;
+  if (!fp)
+    fail(filename, "can't open");
+  if (getc(fp) != 'P' || (kind = getc(fp) - '0') < 1 || kind > 6)
+    fail(filename, "not a PBM/PGM/PPM file");
+  image->width = readInt(fp, filename);
+  image->height = readInt(fp, filename);
+  if (kind != 1 && kind != 4)
+    maxval = readInt(fp, filename);
+  if (maxval <= 0 || maxval > 255)
+    fail(filename, "only 8-bit images are supported");
+  n = image->width * image->height;
+  image->rgb = malloc(3 * n);
+  if (!image->rgb)
+    fail(filename, "out of memory");
+
+  for (i = 0; i < n; i++) {
+    int r, g, b;
+    switch (kind) {
+    case 1:			/* plain bitmap: 1 is black */
+      r = g = b = readInt(fp, filename) ? 0 : 255;
+      break;
+    case 4: {			/* raw bitmap: rows padded to bytes */
+      static int byte, bit = 0;
+      int col = i % image->width;
+      if (col == 0 || bit == 0) {
+	byte = getc(fp);
+	bit = 0x80;
+      }
+      r = g = b = (byte & bit) ? 0 : 255;
+      bit >>= 1;
+      if (col == image->width - 1)
+	bit = 0;		/* next row starts a new byte */
+      break;
+    }
+    case 2:			/* graymap */
+      r = g = b = readInt(fp, filename) * 255 / maxval;
+      break;
+    case 5:
+      r = g = b = getc(fp) * 255 / maxval;
+      break;
+    case 3:			/* pixmap */
+      r = readInt(fp, filename) * 255 / maxval;
+      g = readInt(fp, filename) * 255 / maxval;
+      b = readInt(fp, filename) * 255 / maxval;
+      break;
+    default:			/* 6 */
+      r = getc(fp) * 255 / maxval;
+      g = getc(fp) * 255 / maxval;
+      b = getc(fp) * 255 / maxval;
+    }
+    if (feof(fp))
+      fail(filename, "truncated");
+    image->rgb[3*i] = r, image->rgb[3*i+1] = g, image->rgb[3*i+2] = b;
+  }
+  fclose(fp);
+}
@@ -0,0 +1,17 @@
+// Netpbm (PBM/PGM/PPM) image reader for host-side generators
+#ifndef pnm_included
+#define pnm_included
+
+/** An image as 8-bit RGB triples, row-major */
+typedef struct {
+  int width, height;
+  unsigned char *rgb;
+} PnmImage;
+
+/** Reads any of P1..P6 (plain or raw, bitmap, graymap or pixmap).
+ *  PBM black pixels become (0,0,0) and white (255,255,255).
+ *  Exits with a message if the file can't be read.
+ */
+void pnmRead(PnmImage *image, const char *filename);
+
+#endif // included
@@ -0,0 +1,117 @@
+#include "shape.h"
+
+void
+abPolyInit(AbPoly *poly)
+{
+  u_char i, n = poly->nVerts;
+  const Vec2 *verts = poly->verts;
+  poly->extent.topLeft = poly->extent.botRight = verts[0];
+  for (i = 0; i < n; i++) {
+    const Vec2 *top = &verts[i], *bot = &verts[(i + 1 == n) ? 0 : i + 1];
+    PolyEdge *e = &poly->edges[i];
+    int dx, q = 0;
+    if (top->axes[1] > bot->axes[1]) { /* orient edge downward */
+      const Vec2 *t = top; top = bot; bot = t;
+    }
+    e->yTop = top->axes[1];
+    e->yBot = bot->axes[1];
+    e->xTop = top->axes[0];
+    e->dy = e->yBot - e->yTop;
+    dx = bot->axes[0] - top->axes[0];
+    if (e->dy) {		/* floor(dx/dy) by repeated subtraction (init only) */
+      while (dx < 0) { dx += e->dy; q--; }
+      while (dx >= e->dy) { dx -= e->dy; q++; }
+    }
+    e->qStep = q;
+    e->rStep = dx;		/* horizontal edges keep dx here */
+    vec2Min(&poly->extent.topLeft, &poly->extent.topLeft, &verts[i]);
+    vec2Max(&poly->extent.botRight, &poly->extent.botRight, &verts[i]);
+  }
+  poly->curRow = poly->extent.botRight.axes[1] + 1; /* force restart */
+}
+
+/* advances every edge's intercept to relative row */
+static void
+polySeek(AbPoly *poly, int row)
+{
+  PolyEdge *e, *end = poly->edges + poly->nVerts;
+  int r = poly->curRow;
+  if (row < r) 			/* restart above the top */
+    r = poly->extent.topLeft.axes[1] - 1;
+  while (r < row) {
+    r++;
+    for (e = poly->edges; e < end; e++) {
+      if (r == e->yTop) {
+	e->x = e->xTop;
+	e->rem = 0;
+      } else if (r > e->yTop && r <= e->yBot) {
+	e->x += e->qStep;
+	e->rem += e->rStep;
+	if (e->rem >= e->dy) {
+	  e->x++;
+	  e->rem -= e->dy;
+	}
+      }
+    }
+  }
+  poly->curRow = r;
+}
+
+/* relative columns covered in relative row; false if none */
+static int
+polyRowSpan(const AbPoly *poly, int row, int *colStart, int *colEnd)
+{
+  AbPoly *p = (AbPoly *)poly;	/* only the cursor changes */
+  PolyEdge *e, *end = p->edges + p->nVerts;
+  int left, right;
+  if (row < p->extent.topLeft.axes[1] || row > p->extent.botRight.axes[1])
+    return 0;
+  if (row != p->curRow)
+    polySeek(p, row);
+  left = p->extent.botRight.axes[0] + 1;
+  right = p->extent.topLeft.axes[0] - 1;
+  for (e = p->edges; e < end; e++) {
+    int l, r;
+    if (row < e->yTop || row > e->yBot)
+      continue;
+    if (e->dy == 0) {		/* horizontal: both endpoints */
+      l = e->xTop;
+      r = e->xTop + e->rStep;
+      if (l > r) { int t = l; l = r; r = t; }
+    } else {			/* pixel centers on or right (left) of the edge */
+      l = e->x + (e->rem > 0);
+      r = e->x;
+    }
+    if (l < left) left = l;
+    if (r > right) right = r;
+  }
+  *colStart = left;
+  *colEnd = right;
+  return left <= right;
+}
+
+void
+abPolyGetBounds(const AbPoly *poly, const Vec2 *centerPos, Region *bounds)
+{
+  vec2Add(&bounds->topLeft, centerPos, &poly->extent.topLeft);
+  vec2Add(&bounds->botRight, centerPos, &poly->extent.botRight);
+}
+
+int
+abPolyCheck(const AbPoly *poly, const Vec2 *centerPos, const Vec2 *pixel)
+{
+  int colStart, colEnd, col = pixel->axes[0] - centerPos->axes[0];
+  return (polyRowSpan(poly, pixel->axes[1] - centerPos->axes[1], &colStart, &colEnd) &&
+	  col >= colStart && col <= colEnd);
+}
+
+int
+abPolyRowSpans(const AbPoly *poly, const Vec2 *centerPos, int row, Span *spans)
+{
+  int colStart, colEnd;
+  if (!polyRowSpan(poly, row - centerPos->axes[1], &colStart, &colEnd))
+    return 0;
+  spans[0].colStart = centerPos->axes[0] + colStart;
+  spans[0].colEnd = centerPos->axes[0] + colEnd;
+  return 1;
+}
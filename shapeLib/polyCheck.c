@@ -0,0 +1,127 @@
+#include "stdio.h"
+#include "stdlib.h"
+#include "shape.h"
+
+// Host check of AbPoly's rasterizer against a cross-product reference
+//
+// usage: polyCheck [polygons [seed]]
+//   builds random convex polygons (hulls of random integer points),
+//   then compares every pixel of their bounds, visited top to bottom,
+//   in random order, and alternating between two positions, with an
+//   inside-or-on-every-edge test.  Exits 1 on the first mismatch.
+
+#define MAX_VERTS 8
+#define RANGE 40		/* vertices lie within +-RANGE of the center */
+
+static Vec2 verts[MAX_VERTS];
+static PolyEdge edges[MAX_VERTS];
+static AbPoly poly = { abPolyGetBounds, abPolyCheck, 0, verts, edges };
+
+static long
+cross(const Vec2 *o, const Vec2 *a, const Vec2 *b)
+{
+  return (long)(a->axes[0] - o->axes[0]) * (b->axes[1] - o->axes[1]) -
+    (long)(a->axes[1] - o->axes[1]) * (b->axes[0] - o->axes[0]);
+}
+
+static int
+vecCompare(const void *a, const void *b)
+{
+  const Vec2 *va = a, *vb = b;
+  if (va->axes[0] != vb->axes[0])
+    return va->axes[0] - vb->axes[0];
+  return va->axes[1] - vb->axes[1];
+}
+
+// convex hull (monotone chain) of random points into verts; its size
+static int
+randomHull()
+{
+  Vec2 pts[12], hull[2 * 12];
+  int n = 3 + rand() % 10, i, k = 0, lower;
+  for (i = 0; i < n; i++) {
+    pts[i].axes[0] = rand() % (2 * RANGE + 1) - RANGE;
+    pts[i].axes[1] = rand() % (2 * RANGE + 1) - RANGE;
+  }
+  qsort(pts, n, sizeof(Vec2), vecCompare);
+  for (i = 0; i < n; i++) {
+    while (k >= 2 && cross(&hull[k-2], &hull[k-1], &pts[i]) <= 0) k--;
+    hull[k++] = pts[i];
+  }
+  for (i = n - 2, lower = k + 1; i >= 0; i--) {
+    while (k >= lower && cross(&hull[k-2], &hull[k-1], &pts[i]) <= 0) k--;
+    hull[k++] = pts[i];
+  }
+  k--;				/* last point repeats the first */
+  if (k < 3 || k > MAX_VERTS)
+    return 0;
+  for (i = 0; i < k; i++)
+    verts[i] = hull[i];
+  return k;
+}
+
+// true if relative pixel (col, row) is inside or on the (ccw) polygon
+static int
+reference(int col, int row)
+{
+  Vec2 p;
+  int i, n = poly.nVerts;
+  p.axes[0] = col;
+  p.axes[1] = row;
+  for (i = 0; i < n; i++)
+    if (cross(&verts[i], &verts[(i + 1) % n], &p) < 0)
+      return 0;
+  return 1;
+}
+
+static int
+checkPixel(const Vec2 *pos, int col, int row)
+{
+  Vec2 pixel;
+  pixel.axes[0] = pos->axes[0] + col;
+  pixel.axes[1] = pos->axes[1] + row;
+  if (abPolyCheck(&poly, pos, &pixel) != reference(col, row)) {
+    int i;
+    printf("mismatch at (%d, %d) in:", col, row);
+    for (i = 0; i < poly.nVerts; i++)
+      printf(" (%d, %d)", verts[i].axes[0], verts[i].axes[1]);
+    printf("\n");
+    return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int polygons = argc > 1 ? atoi(argv[1]) : 200, done = 0, i;
+  Vec2 posA = {{60, 80}}, posB = {{20, 30}};
+  srand(argc > 2 ? atoi(argv[2]) : 1);
+  while (done < polygons) {
+    int n = randomHull(), row, col, top, bot, left, right;
+    if (!n)
+      continue;
+    poly.nVerts = n;
+    abPolyInit(&poly);
+    top = poly.extent.topLeft.axes[1] - 2;
+    bot = poly.extent.botRight.axes[1] + 2;
+    left = poly.extent.topLeft.axes[0] - 2;
+    right = poly.extent.botRight.axes[0] + 2;
+    for (row = top; row <= bot; row++)	/* rendering order */
+      for (col = left; col <= right; col++)
+	if (!checkPixel(&posA, col, row))
+	  return 1;
+    for (i = 0; i < 500; i++) { /* random order */
+      row = top + rand() % (bot - top + 1);
+      col = left + rand() % (right - left + 1);
+      if (!checkPixel(&posA, col, row))
+	return 1;
+    }
+    for (row = top; row <= bot; row++) /* two layers sharing the polygon */
+      for (col = left; col <= right; col++)
+	if (!checkPixel(&posA, col, row) || !checkPixel(&posB, col, bot - (row - top)))
+	  return 1;
+    done++;
+  }
+  printf("%d polygons ok\n", polygons);
+  return 0;
+}
@@ -0,0 +1,86 @@
+#include "shape.h"
+#include "pool.h"
+#include "critical.h"
+
+void *
+poolAlloc(Pool *pool)
+{
+  void *slot;
+  CRIT_ENTER();
+  slot = pool->freeList;
+  if (slot) {			/* reuse a freed slot */
+    pool->freeList = *(void **)slot;
+  } else if (pool->fresh < pool->capacity) { /* take a never-used slot */
+    slot = pool->slots + pool->fresh * pool->slotSize;
+    pool->fresh++;
+  } else {			/* exhausted */
+    if (pool->failures != (u_int)~0)
+      pool->failures++;
+    CRIT_EXIT();
+    return 0;
+  }
+  if (++pool->inUse > pool->highWater)
+    pool->highWater = pool->inUse;
+  CRIT_EXIT();
+  return slot;
+}
+
+void
+poolFree(Pool *pool, void *slot)
+{
+  if (slot) {
+    CRIT_ENTER();
+    *(void **)slot = pool->freeList; /* thread freelist through the slot */
+    pool->freeList = slot;
+    pool->inUse--;
+    CRIT_EXIT();
+  }
+}
+
+void
+poolReset(Pool *pool)
+{
+  CRIT_ENTER();
+  pool->freeList = 0;
+  pool->fresh = 0;
+  pool->inUse = 0;
+  CRIT_EXIT();
+}
+
+Layer *
+layerAlloc(Pool *pool, AbShape *abShape, const Vec2 *pos, u_int color, Layer *next)
+{
+  Layer *l = poolAlloc(pool);
+  if (l) {
+    l->abShape = abShape;
+    l->pos = l->posLast = l->posNext = *pos;
+    l->color = color;
+    l->next = next;
+  }
+  return l;
+}
+
+MovLayer *
+movLayerAlloc(Pool *pool, Layer *layer, const Vec2 *velocity, MovLayer *next)
+{
+  MovLayer *ml = poolAlloc(pool);
+  if (ml) {
+    ml->layer = layer;
+    ml->velocity = *velocity;
+    ml->next = next;
+    ml->period = ml->countdown = 0;
+  }
+  return ml;
+}
+
+AbRect *
+abRectAlloc(Pool *pool, const Vec2 *halfSize)
+{
+  AbRect *r = poolAlloc(pool);
+  if (r) {
+    r->getBounds = abRectGetBounds;
+    r->check = abRectCheck;
+    *(Vec2 *)&r->halfSize = *halfSize; /* halfSize is const once built */
+  }
+  return r;
+}
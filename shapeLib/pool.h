@@ -0,0 +1,99 @@
+/** \file pool.h
+ *  \brief Fixed-capacity object pools for objects created during play.
+ */
+
+#ifndef pool_included
+#define pool_included
+
+#include "shape.h"
+
+/** A pool of equal-sized slots carved from static storage.
+ *
+ *  Free slots are kept on a singly-linked freelist threaded through
+ *  the slots themselves (the first word of a free slot points to the
+ *  next free slot), so alloc and free are O(1) and need no heap.
+ *  Slots that have never been handed out are taken in order from
+ *  "fresh", which lets a pool be defined with a static initializer
+ *  and used without calling an init function.
+ *
+ *  Statistics:
+ *   - inUse: slots currently allocated
+ *   - highWater: maximum value inUse has reached
+ *   - failures: allocations refused because the pool was empty
+ *     (saturates)
+ *
+ *  Allocation and freeing mask interrupts briefly, so a pool may be
+ *  shared between interrupt handlers (e.g. spawning from a timer
+ *  tick) and main.
+ */
+typedef struct Pool_s {
+  u_char *slots;		/* first slot */
+  u_int slotSize;		/* bytes per slot, at least sizeof(void *) */
+  u_int capacity;		/* number of slots */
+  u_int fresh;			/* slots never handed out start here */
+  void *freeList;		/* recycled slots */
+  u_int inUse, highWater, failures;
+} Pool;
+
+/** Defines a pool named name holding capacity objects of type type.
+ *
+ *  type must be at least as large as a pointer (true of Layers,
+ *  MovLayers and every AbShape, which begin with pointers).
+ */
+#define POOL_DEFINE(name, type, capacity)				\
+  type name##_slots[capacity];						\
+  Pool name = { (u_char *)name##_slots, sizeof(type), capacity, 0, 0, 0, 0, 0 }
+
+/** As POOL_DEFINE, but the pool (and its storage) is private to the file
+ */
+#define POOL_DEFINE_STATIC(name, type, capacity)			\
+  static type name##_slots[capacity];					\
+  static Pool name = { (u_char *)name##_slots, sizeof(type), capacity, 0, 0, 0, 0, 0 }
+
+/** Typed allocation from a pool defined with POOL_DEFINE
+ */
+#define POOL_ALLOC(pool, type) ((type *)poolAlloc(&(pool)))
+
+/** Returns an unused slot, or 0 if the pool is exhausted.  O(1).
+ *  The slot's contents are not cleared.
+ */
+void *poolAlloc(Pool *pool);
+
+/** Returns slot (previously obtained from pool) to the pool.  O(1).
+ */
+void poolFree(Pool *pool, void *slot);
+
+/** Returns every slot to the pool and clears inUse (but not highWater).
+ */
+void poolReset(Pool *pool);
+
+/** Allocates a layer from pool and initializes it at pos.
+ *
+ *  \param pool (in) A pool of Layers
+ *  \param abShape (in) The shape the layer renders
+ *  \param pos (in) The layer's initial position (also its last & next)
+ *  \param color (in) The layer's color
+ *  \param next (in) The layer below this one
+ *  \return The new layer, or 0 if the pool is exhausted
+ */
+Layer *layerAlloc(Pool *pool, AbShape *abShape, const Vec2 *pos,
+		  u_int color, Layer *next);
+
+/** Allocates a moving layer from pool, moving layer every tick
+ *
+ *  \param pool (in) A pool of MovLayers
+ *  \param layer (in) The layer it moves
+ *  \param velocity (in) Its motion per move
+ *  \param next (in) The next moving layer (for mlAdvance, movLayerDraw)
+ *  \return The new moving layer, or 0 if the pool is exhausted
+ */
+MovLayer *movLayerAlloc(Pool *pool, Layer *layer, const Vec2 *velocity,
+			MovLayer *next);
+
+/** Allocates and initializes a filled rectangle (AbRect) from pool
+ *
+ *  \return The new rect, or 0 if the pool is exhausted
+ */
+AbRect *abRectAlloc(Pool *pool, const Vec2 *halfSize);
+
+#endif // included
@@ -0,0 +1,104 @@
+#include "stdio.h"
+#include "stdlib.h"
+
+// Host check of the object pools (pool.h) against a model
+//
+// usage: poolCheck [operations [seed]]
+//   runs random allocations and frees on pools of Layers, MovLayers
+//   and AbRects, checking that live slots are distinct, lie within
+//   the pool, keep their contents, and that inUse, highWater and
+//   failures match the model.  Exits 1 on the first mismatch.
+
+#define critical_included	/* no interrupts on the host */
+#define CRIT_ENTER()
+#define CRIT_EXIT()
+#include "pool.c"
+
+#define CAPACITY 300		/* more than a u_char holds */
+
+POOL_DEFINE(layerPool, Layer, CAPACITY);
+POOL_DEFINE_STATIC(mlPool, MovLayer, 4);
+POOL_DEFINE_STATIC(rectPool, AbRect, 1);
+
+static Layer *live[CAPACITY];
+static int nLive;
+
+static int
+fail(const char *what)
+{
+  printf("poolCheck: %s (inUse %u, highWater %u, failures %u)\n", what,
+	 layerPool.inUse, layerPool.highWater, layerPool.failures);
+  return 1;
+}
+
+int main(int argc, char **argv)
+{
+  int ops = argc > 1 ? atoi(argv[1]) : 100000, i, j;
+  u_int highWater = 0, failures = 0;
+  Vec2 pos = {{0, 0}}, velocity = {{1, 2}}, halfSize = {{3, 4}};
+  Layer *l;
+  MovLayer *ml = 0, *m;
+  AbRect *rect;
+  srand(argc > 2 ? atoi(argv[2]) : 1);
+
+  for (i = 0; i < ops; i++) {
+    if (nLive && (rand() % 2 || nLive == CAPACITY) && rand() % 8) { /* free one */
+      j = rand() % nLive;
+      if (live[j]->color != (u_int)(live[j] - layerPool_slots))
+	return fail("slot contents changed while allocated");
+      poolFree(&layerPool, live[j]);
+      live[j] = live[--nLive];
+    } else {			/* allocate one */
+      pos.axes[0] = i;
+      l = layerAlloc(&layerPool, (AbShape *)0, &pos, 0, 0);
+      if (!l) {
+	if (nLive != CAPACITY)
+	  return fail("allocation refused with slots free");
+	failures++;
+	continue;
+      }
+      if (nLive == CAPACITY)
+	return fail("allocated beyond capacity");
+      if (l < layerPool_slots || l >= layerPool_slots + CAPACITY)
+	return fail("slot outside the pool");
+      for (j = 0; j < nLive; j++)
+	if (live[j] == l)
+	  return fail("slot handed out twice");
+      if (l->pos.axes[0] != i || l->posNext.axes[0] != i)
+	return fail("layerAlloc did not initialize the layer");
+      l->color = l - layerPool_slots; /* tag to check it survives */
+      live[nLive++] = l;
+      if (nLive > highWater)
+	highWater = nLive;
+    }
+    if (layerPool.inUse != nLive || layerPool.highWater != highWater ||
+	layerPool.failures != failures)
+      return fail("statistics differ from the model");
+  }
+  if (highWater < CAPACITY)
+    return fail("never filled the pool (use more operations)");
+
+  for (i = 0; i < 5; i++)	/* a chain of MovLayers: the 5th is refused */
+    if ((m = movLayerAlloc(&mlPool, live[0], &velocity, ml)))
+      ml = m;
+  if (mlPool.inUse != 4 || mlPool.failures != 1 || !ml ||
+      ml->velocity.axes[1] != 2 || ml->period || ml->countdown ||
+      !ml->next || ml->next->next->next->next)
+    return fail("movLayerAlloc");
+
+  rect = abRectAlloc(&rectPool, &halfSize);
+  if (!rect || rect->halfSize.axes[1] != 4 || rect->check != abRectCheck ||
+      abRectAlloc(&rectPool, &halfSize))
+    return fail("abRectAlloc");
+  poolFree(&rectPool, rect);
+  if (abRectAlloc(&rectPool, &halfSize) != rect)
+    return fail("freed slot not reused");
+
+  poolReset(&layerPool);
+  if (layerPool.inUse || layerPool.highWater != highWater ||
+      !layerAlloc(&layerPool, (AbShape *)0, &pos, 0, 0))
+    return fail("poolReset");
+
+  printf("%d operations ok (high water %u, %u refused)\n", ops, highWater, failures);
+  return 0;
+}
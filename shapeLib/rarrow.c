@@ -38,3 +38,25 @@ abRArrowGetBounds(const AbRArrow *arrow, const Vec2 *centerPos, Region *bounds)
 }
 
 
+/** Row-span function required by AbSpanClass
+ *  Closed form of abRArrowCheck: the tip covers cols row..halfSize
+ *  left of the tip, and the stem continues to size for |row| <= quarterSize
+ */
+int
+abRArrowRowSpans(const AbRArrow *arrow, const Vec2 *centerPos, int row, Span *spans)
+{
+  int size = arrow->size;
+  int halfSize = size/2, quarterSize = halfSize/2;
+  int colMax;			/* farthest col (leftward) from the tip */
+  row -= centerPos->axes[1];
+  row = (row >= 0) ? row : -row;/* row = |row| */
+  if (row <= quarterSize)	/* tip and stem */
+    colMax = size;
+  else if (row <= halfSize)	/* just tip */
+    colMax = halfSize;
+  else
+    return 0;
+  spans[0].colStart = centerPos->axes[0] - colMax;
+  spans[0].colEnd = centerPos->axes[0] - row;
+  return 1;
+}
@@ -51,3 +51,36 @@ void abRectOutlineGetBounds(const AbRectOutline *rect, const Vec2 *centerPos, Re
 
 
 
+// the rect's columns, if row crosses it
+int
+abRectRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span *spans)
+{
+  Region bounds;
+  abRectGetBounds(rect, centerPos, &bounds);
+  if (row < bounds.topLeft.axes[1] || row > bounds.botRight.axes[1])
+    return 0;
+  spans[0].colStart = bounds.topLeft.axes[0];
+  spans[0].colEnd = bounds.botRight.axes[0];
+  return 1;
+}
+
+// full width at top & bottom, otherwise just the left & right sides
+int
+abRectOutlineRowSpans(const AbRectOutline *rect, const Vec2 *centerPos, int row, Span *spans)
+{
+  Region bounds;
+  int left, right;
+  abRectOutlineGetBounds(rect, centerPos, &bounds);
+  left = bounds.topLeft.axes[0], right = bounds.botRight.axes[0];
+  if (row < bounds.topLeft.axes[1] || row > bounds.botRight.axes[1])
+    return 0;
+  if (row == bounds.topLeft.axes[1] || row == bounds.botRight.axes[1] ||
+      right - left <= 1) {	/* no gap between sides */
+    spans[0].colStart = left;
+    spans[0].colEnd = right;
+    return 1;
+  }
+  spans[0].colStart = spans[0].colEnd = left;
+  spans[1].colStart = spans[1].colEnd = right;
+  return 2;
+}
@@ -1,4 +1,5 @@
 #include "shape.h"
+#include "framestats.h"
 
 const Vec2 screenSize = {screenWidth, screenHeight};
 const Vec2 screenCenter= {screenWidth/2, screenHeight/2};
@@ -19,6 +20,59 @@ abShapeGetBounds(const AbShape *s, const Vec2 *centerPos, Region *bounds)
 int
 abShapeCheck(const AbShape *s, const Vec2 *centerPos, const Vec2 *pixelLoc)
 {
+  FRAME_COUNT(frameChecks);
   return (*s->check)(s, centerPos, pixelLoc);
 }
 
+
+/* row-span functions for shapeLib's own shapes */
+static AbSpanClass maskSpans = {
+  (AbCheckFn)abMaskCheck, (AbRowSpansFn)abMaskRowSpans, 0
+};
+static AbSpanClass polySpans = {
+  (AbCheckFn)abPolyCheck, (AbRowSpansFn)abPolyRowSpans, &maskSpans
+};
+static AbSpanClass differenceSpans = {
+  (AbCheckFn)abDifferenceCheck, (AbRowSpansFn)abDifferenceRowSpans, &polySpans
+};
+static AbSpanClass intersectSpans = {
+  (AbCheckFn)abIntersectCheck, (AbRowSpansFn)abIntersectRowSpans, &differenceSpans
+};
+static AbSpanClass unionSpans = {
+  (AbCheckFn)abUnionCheck, (AbRowSpansFn)abUnionRowSpans, &intersectSpans
+};
+static AbSpanClass groupSpans = {
+  (AbCheckFn)abGroupCheck, (AbRowSpansFn)abGroupRowSpans, &unionSpans
+};
+static AbSpanClass rArrowSpans = {
+  (AbCheckFn)abRArrowCheck, (AbRowSpansFn)abRArrowRowSpans, &groupSpans
+};
+static AbSpanClass rectOutlineSpans = {
+  (AbCheckFn)abRectOutlineCheck, (AbRowSpansFn)abRectOutlineRowSpans, &rArrowSpans
+};
+static AbSpanClass rectSpans = {
+  (AbCheckFn)abRectCheck, (AbRowSpansFn)abRectRowSpans, &rectOutlineSpans
+};
+
+static AbSpanClass *spanClasses = &rectSpans;
+
+void
+abShapeRegisterSpans(AbSpanClass *spanClass)
+{
+  AbSpanClass *c;
+  for (c = spanClasses; c; c = c->next)
+    if (c == spanClass)		/* already registered */
+      return;
+  spanClass->next = spanClasses;
+  spanClasses = spanClass;
+}
+
+int
+abShapeRowSpans(const AbShape *s, const Vec2 *centerPos, int row, Span *spans)
+{
+  AbSpanClass *c;
+  for (c = spanClasses; c; c = c->next)
+    if (c->check == s->check)
+      return (*c->rowSpans)(s, centerPos, row, spans);
+  return -1;			/* unknown shape */
+}
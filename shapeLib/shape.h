@@ -102,6 +102,67 @@ void abShapeGetBounds(const AbShape *s, const Vec2 *centerPos, Region *bounds);
  */
 int abShapeCheck(const AbShape *shape, const Vec2 *centerPos, const Vec2 *pixelLoc);
 
+/** A horizontal run of pixels within one row, from colStart to 
+ *  colEnd inclusive (screen coordinates, not clipped)
+ */
+typedef struct {
+  int colStart, colEnd;
+} Span;
+
+/** Maximum number of spans a shape may report for one row
+ */
+#define ABSHAPE_MAX_SPANS 4
+
+/** Type of an AbShape's check function
+ */
+typedef int (*AbCheckFn)(const AbShape *shape, const Vec2 *centerPos, const Vec2 *pixelLoc);
+
+/** Computes the spans an AbShape covers in a row.
+ *
+ *  Writes at most ABSHAPE_MAX_SPANS disjoint spans, sorted left to
+ *  right, into spans.
+ *  \return The number of spans, or -1 if the shape can't describe
+ *  this row with spans (the caller must then use check)
+ */
+typedef int (*AbRowSpansFn)(const AbShape *shape, const Vec2 *centerPos, int row, Span *spans);
+
+/** Associates a row-span function with all AbShapes that have a
+ *  particular check function.
+ *
+ *  Row spans let renderers and collision tests work a row at a time
+ *  instead of a pixel at a time.  shapeLib's own shapes are registered
+ *  already.  Other libraries register theirs with abShapeRegisterSpans.
+ */
+typedef struct AbSpanClass_s {
+  AbCheckFn check;
+  AbRowSpansFn rowSpans;
+  struct AbSpanClass_s *next;
+} AbSpanClass;
+
+/** Registers a span class (once; spanClass must remain allocated)
+ */
+void abShapeRegisterSpans(AbSpanClass *spanClass);
+
+/** Computes the spans shape covers in row when centered at centerPos.
+ *
+ *  \return As AbRowSpansFn: the number of spans, or -1 if shape has
+ *  no registered row-span function
+ */
+int abShapeRowSpans(const AbShape *shape, const Vec2 *centerPos, int row, Span *spans);
+
+/** Pixel-exact overlap test between two placed shapes.
+ *
+ *  Only rows where both shapes' bounds overlap are examined, one
+ *  row at a time, by intersecting the shapes' row spans.  Shapes
+ *  without row spans fall back to per-pixel checks.
+ *
+ *  \param contact (out, may be 0) The first (topmost, then leftmost)
+ *  pixel covered by both shapes
+ *  \return True (1) if the shapes share at least one pixel
+ */
+int abShapeOverlap(const AbShape *a, const Vec2 *posA,
+		   const AbShape *b, const Vec2 *posB, Vec2 *contact);
+
 /** An AbShape Right Arrow with filled tip
  *
  *  size: width of the arrow.  Tip is a triangle with width=1/2 size.
@@ -121,6 +182,10 @@ void abRArrowGetBounds(const AbRArrow *arrow, const Vec2 *centerPos, Region *bou
  */
 int abRArrowCheck(const AbRArrow *arrow, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbSpanClass
+ */
+int abRArrowRowSpans(const AbRArrow *arrow, const Vec2 *centerPos, int row, Span *spans);
+
 /** AbShape rectangle
  *
  *  Vector halfSize must be to first quadrant (both axes non-negative).  
@@ -140,6 +205,10 @@ void abRectGetBounds(const AbRect *rect, const Vec2 *centerPos, Region *bounds);
  */
 int abRectCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbSpanClass
+ */
+int abRectRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span *spans);
+
 typedef AbRect AbRectOutline;	/* same as AbRect */
 
 /** As required by AbShape
@@ -150,6 +219,10 @@ void abRectOutlineGetBounds(const AbRect *rect, const Vec2 *centerPos, Region *b
  */
 int abRectOutlineCheck(const AbRect *rect, const Vec2 *centerPos, const Vec2 *pixel);
 
+/** As required by AbSpanClass
+ */
+int abRectOutlineRowSpans(const AbRect *rect, const Vec2 *centerPos, int row, Span *spans);
+
 /** Linked list of Layers.  
  * 
  *  Each layer contains
@@ -179,6 +252,253 @@ void layerInit(Layer *layers);
  */
 void layerDraw(Layer *layers);
 
+/** Maximum runs of distinct layers layerDrawRegion composites per row
+ *  (rows needing more are drawn pixel by pixel)
+ */
+#define LAYER_ROW_RUNS 12
+
+/** Render the layers within area (clipped to the screen).
+ *
+ *  Each row is composited from the layers' row spans (see
+ *  abShapeRowSpans) and sent to the LCD as color runs.  Rows with a
+ *  layer lacking row spans are drawn by probing each pixel.
+ */
+void layerDrawRegion(const Layer *layers, const Region *area);
+
+/** Color of the topmost layer containing pixelPos, or bgColor.
+ *  Groups are searched through their children.
+ */
+u_int layerProbe(const Layer *layers, const Vec2 *pixelPos);
+
+/** AbShape group: a composite of child layers
+ *
+ *  Children's positions are relative to the group's center, so moving
+ *  the group's layer moves every child.  Each child keeps its own
+ *  color.  extent caches the children's combined bounds relative to
+ *  the center (set by abGroupInit), so a whole group can be rejected
+ *  with one box test by the renderer and by collision tests.
+ */
+typedef struct AbGroup_s {
+  void (*getBounds)(const struct AbGroup_s *group, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbGroup_s *group, const Vec2 *centerPos, const Vec2 *pixel);
+  Layer *children;		/* positions relative to group center */
+  Region extent;		/* computed by abGroupInit */
+} AbGroup;
+
+/** Computes group's cached extent.  Call again after changing children.
+ *  Nested groups must be initialized before the groups containing them.
+ */
+void abGroupInit(AbGroup *group);
+
+/** As required by AbShape
+ */
+void abGroupGetBounds(const AbGroup *group, const Vec2 *centerPos, Region *bounds);
+
+/** As required by AbShape: true if any child contains pixel
+ */
+int abGroupCheck(const AbGroup *group, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** As required by AbSpanClass: the union of the children's spans
+ */
+int abGroupRowSpans(const AbGroup *group, const Vec2 *centerPos, int row, Span *spans);
+
+/** Compound (CSG) AbShapes combining two child shapes
+ *
+ *  Child a is centered at the compound's center and child b at 
+ *  center + bOffset.  Rendering computes coverage a row at a time by
+ *  merging the children's row spans (rowSpans); check, used only for
+ *  single pixels (layerProbe), checks the children directly.
+ *
+ *   - AbUnion: pixels in a or b
+ *   - AbIntersect: pixels in both a and b
+ *   - AbDifference: pixels in a but not b (e.g. a circle with a 
+ *     wedge removed)
+ */
+typedef struct AbCsg_s {
+  void (*getBounds)(const struct AbCsg_s *csg, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbCsg_s *csg, const Vec2 *centerPos, const Vec2 *pixel);
+  const AbShape *a, *b;
+  const Vec2 bOffset;		/* b's center relative to a's */
+} AbCsg;
+
+typedef AbCsg AbUnion, AbIntersect, AbDifference;
+
+/** As required by AbShape
+ */
+void abUnionGetBounds(const AbUnion *u, const Vec2 *centerPos, Region *bounds);
+int abUnionCheck(const AbUnion *u, const Vec2 *centerPos, const Vec2 *pixel);
+int abUnionRowSpans(const AbUnion *u, const Vec2 *centerPos, int row, Span *spans);
+
+/** As required by AbShape
+ */
+void abIntersectGetBounds(const AbIntersect *i, const Vec2 *centerPos, Region *bounds);
+int abIntersectCheck(const AbIntersect *i, const Vec2 *centerPos, const Vec2 *pixel);
+int abIntersectRowSpans(const AbIntersect *i, const Vec2 *centerPos, int row, Span *spans);
+
+/** As required by AbShape
+ */
+void abDifferenceGetBounds(const AbDifference *d, const Vec2 *centerPos, Region *bounds);
+int abDifferenceCheck(const AbDifference *d, const Vec2 *centerPos, const Vec2 *pixel);
+int abDifferenceRowSpans(const AbDifference *d, const Vec2 *centerPos, int row, Span *spans);
+
+/** One edge of an AbPoly, prepared by abPolyInit
+ *
+ *  The edge's intercept with row y is x + rem/dy.  Moving down a row
+ *  adds qStep to x and rStep to rem (carrying into x when rem reaches
+ *  dy), so no multiplies or divides are needed while rendering.
+ */
+typedef struct {
+  int yTop, yBot;		/* rows spanned (relative to center) */
+  int xTop;			/* column at yTop */
+  int dy;			/* yBot - yTop (0 if horizontal) */
+  int qStep, rStep;		/* dx/dy as quotient & remainder */
+  int x, rem;			/* intercept at the polygon's curRow */
+} PolyEdge;
+
+/** AbShape convex polygon
+ *
+ *  verts: nVerts vertices (relative to the center) listed in order 
+ *  around the polygon, which must be convex.
+ *  edges: scratch for nVerts edges, filled by abPolyInit.
+ *
+ *  Rows are rasterized by stepping each edge's intercept from the
+ *  previous row, so rendering top to bottom costs a few additions per
+ *  row.  A pixel is covered when its center is within the polygon.  
+ *  Since an AbPoly remembers its current row it must be in RAM, and
+ *  should not be drawn from both an ISR and main.  The row is relative
+ *  to the center, so layers sharing an AbPoly at different positions
+ *  (or a layer whose rows are checked out of order) restart the edges
+ *  from the top on most checks, costing O(rows) each: give such layers
+ *  their own AbPoly and PolyEdges.
+ */
+typedef struct AbPoly_s {
+  void (*getBounds)(const struct AbPoly_s *poly, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbPoly_s *poly, const Vec2 *centerPos, const Vec2 *pixel);
+  u_char nVerts;
+  const Vec2 *verts;
+  PolyEdge *edges;
+  Region extent;		/* relative to center: set by abPolyInit */
+  int curRow;			/* relative row of the edges' intercepts */
+} AbPoly;
+
+/** Prepares poly's edges and extent.  Call once before use.
+ */
+void abPolyInit(AbPoly *poly);
+
+/** As required by AbShape
+ */
+void abPolyGetBounds(const AbPoly *poly, const Vec2 *centerPos, Region *bounds);
+
+/** As required by AbShape
+ */
+int abPolyCheck(const AbPoly *poly, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** As required by AbSpanClass
+ */
+int abPolyRowSpans(const AbPoly *poly, const Vec2 *centerPos, int row, Span *spans);
+
+/** AbShape defined by a 1-bit-per-pixel bitmap (usually in flash)
+ *
+ *  bits: row-major, most significant bit leftmost.  Each row occupies
+ *  (1 << rowShift) bytes so a row's address is computed with a shift.
+ *  rowFirst, rowLast: first and last set column of each row 
+ *  (rowFirst > rowLast for empty rows), letting empty rows and columns
+ *  be skipped without examining bits.
+ *  The mask is centered at (width/2, height/2).
+ *
+ *  Masks are normally generated from PBM/PGM/PPM images by makeMask.
+ */
+typedef struct AbMask_s {
+  void (*getBounds)(const struct AbMask_s *mask, const Vec2 *centerPos, Region *bounds);
+  int (*check)(const struct AbMask_s *mask, const Vec2 *centerPos, const Vec2 *pixel);
+  u_char width, height, rowShift;
+  const u_char *bits;
+  const u_char *rowFirst, *rowLast;
+} AbMask;
+
+/** As required by AbShape
+ */
+void abMaskGetBounds(const AbMask *mask, const Vec2 *centerPos, Region *bounds);
+
+/** As required by AbShape
+ */
+int abMaskCheck(const AbMask *mask, const Vec2 *centerPos, const Vec2 *pixel);
+
+/** As required by AbSpanClass (-1 if a row has too many runs)
+ */
+int abMaskRowSpans(const AbMask *mask, const Vec2 *centerPos, int row, Span *spans);
+
+/** Merges two sorted span lists into their union.
+ *  
+ *  \param out (out) Room for ABSHAPE_MAX_SPANS spans (may not alias a or b)
+ *  \return The number of spans in out, or -1 if more than ABSHAPE_MAX_SPANS
+ */
+int spansUnion(Span *out, const Span *a, int na, const Span *b, int nb);
+
+/** As spansUnion, but computes the intersection of a and b
+ */
+int spansIntersect(Span *out, const Span *a, int na, const Span *b, int nb);
+
+/** As spansUnion, but computes a minus b
+ */
+int spansDifference(Span *out, const Span *a, int na, const Span *b, int nb);
+
+/** Moving Layer
+ *  Linked list of layer references
+ *  Velocity represents one iteration of change (direction & magnitude)
+ *
+ *  period: the layer moves by velocity once every period calls to 
+ *  mlAdvance (0 or 1 means every call).  Slow objects with a longer
+ *  period are integrated and redrawn less often.
+ *  countdown: calls remaining until the next move (maintained by mlAdvance)
+ */
+typedef struct MovLayer_s {
+  Layer *layer;
+  Vec2 velocity;
+  struct MovLayer_s *next;
+  u_char period, countdown;	/* initially 0 */
+} MovLayer;
+
+/** Advances each moving layer whose period has elapsed, 
+ *  bouncing it off the walls of fence.
+ *
+ *  Updates each layer's posNext, then publishes them (mlPublish).
+ */
+void mlAdvance(MovLayer *ml, const Region *fence);
+
+/** Advances a single moving layer (ignoring ml->next) within fence,
+ *  regardless of its period.  Call mlPublish once all of a frame's
+ *  moves have been made.
+ */
+void movLayerAdvance(MovLayer *ml, const Region *fence);
+
+/** Count of frames of posNext published by the interrupt handler.
+ *
+ *  Readers snapshot posNext and retry if mlSeq changed meanwhile,
+ *  so neither side needs to mask interrupts.
+ */
+extern volatile u_int mlSeq;
+
+/** Publishes a complete frame of posNext updates (bumps mlSeq).
+ *
+ *  Called from the interrupt handler that moves layers, after its
+ *  last update to posNext.  Only one writer may run at a time, so that
+ *  handler must not be nested (isr.h).
+ */
+void mlPublish();
+
+/** Moves each layer to posNext and redraws the region it vacated 
+ *  and now occupies.  Layers that have not moved since the last call
+ *  are not redrawn.
+ *
+ *  posNext is read as a consistent snapshot (see mlSeq), without
+ *  disabling interrupts.
+ *
+ *  \param movLayers (in) The moving layers
+ *  \param layers (in) All layers, which are probed to determine pixel colors
+ */
+void movLayerDraw(MovLayer *movLayers, Layer *layers);
+
 /** Background color.
   */
 extern u_int bgColor;		/*  background color */
@@ -0,0 +1,77 @@
+#include "shape.h"
+
+int
+spansUnion(Span *out, const Span *a, int na, const Span *b, int nb)
+{
+  int n = 0;
+  while (na > 0 || nb > 0) {
+    const Span *next;		/* the span starting furthest left */
+    if (nb == 0 || (na > 0 && a->colStart <= b->colStart)) {
+      next = a++; na--;
+    } else {
+      next = b++; nb--;
+    }
+    if (n > 0 && next->colStart <= out[n-1].colEnd + 1) { /* touches last */
+      if (next->colEnd > out[n-1].colEnd)
+	out[n-1].colEnd = next->colEnd;
+    } else if (n < ABSHAPE_MAX_SPANS) {
+      out[n++] = *next;
+    } else {
+      return -1;		/* too many spans */
+    }
+  }
+  return n;
+}
+
+int
+spansIntersect(Span *out, const Span *a, int na, const Span *b, int nb)
+{
+  int n = 0;
+  while (na > 0 && nb > 0) {
+    int start = a->colStart > b->colStart ? a->colStart : b->colStart;
+    int end = a->colEnd < b->colEnd ? a->colEnd : b->colEnd;
+    if (start <= end) {
+      if (n == ABSHAPE_MAX_SPANS)
+	return -1;		/* too many spans */
+      out[n].colStart = start;
+      out[n++].colEnd = end;
+    }
+    if (a->colEnd < b->colEnd) { /* advance the span that ends first */
+      a++; na--;
+    } else {
+      b++; nb--;
+    }
+  }
+  return n;
+}
+
+int
+spansDifference(Span *out, const Span *a, int na, const Span *b, int nb)
+{
+  int n = 0;
+  for (; na > 0; a++, na--) {
+    int start = a->colStart;	/* start of what's left of *a */
+    while (nb > 0 && b->colEnd < start) { /* skip b spans left of *a */
+      b++; nb--;
+    }
+    const Span *cut = b;
+    int nCut = nb;
+    for (; nCut > 0 && cut->colStart <= a->colEnd; cut++, nCut--) {
+      if (cut->colStart > start) { /* keep piece left of cut */
+	if (n == ABSHAPE_MAX_SPANS)
+	  return -1;
+	out[n].colStart = start;
+	out[n++].colEnd = cut->colStart - 1;
+      }
+      if (cut->colEnd + 1 > start)
+	start = cut->colEnd + 1;
+    }
+    if (start <= a->colEnd) {	/* keep remainder */
+      if (n == ABSHAPE_MAX_SPANS)
+	return -1;
+      out[n].colStart = start;
+      out[n++].colEnd = a->colEnd;
+    }
+  }
+  return n;
+}
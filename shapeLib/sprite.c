@@ -0,0 +1,110 @@
+#include "lcdutils.h"
+#include "shape.h"
+#include "sprite.h"
+
+void
+spriteGetBounds(const Sprite *sprite, const Vec2 *centerPos, Region *bounds)
+{
+  bounds->topLeft.axes[0] = centerPos->axes[0] - (sprite->width >> 1);
+  bounds->topLeft.axes[1] = centerPos->axes[1] - (sprite->height >> 1);
+  bounds->botRight.axes[0] = bounds->topLeft.axes[0] + sprite->width - 1;
+  bounds->botRight.axes[1] = bounds->topLeft.axes[1] + sprite->height - 1;
+}
+
+/* Writes the pixels of sprite row spriteRow between screen cols
+   colStart and colEnd (already clipped) to the current LCD area.
+   left is the screen col of the sprite's first col. */
+static void
+spriteDrawRowSpan(const Sprite *sprite, int spriteRow, int left,
+		  int colStart, int colEnd, int screenRow, const Layer *layers)
+{
+  const u_char *run = sprite->runs + sprite->rowStart[spriteRow];
+  int col = left;		/* first col of *run */
+  while (col <= colEnd) {
+    int start = col, end = col + run[0] - 1; /* cols of this run */
+    u_char index = run[1];
+    run += 2;
+    col = end + 1;
+    if (start < colStart)	/* clip */
+      start = colStart;
+    if (end > colEnd)
+      end = colEnd;
+    if (start > end)
+      continue;
+    if (index != sprite->transparent) { /* opaque: one color run */
+      lcd_writeColorRun(sprite->palette[index], end - start + 1);
+    } else {			/* see-through: probe what's beneath */
+      Vec2 pixelPos;
+      pixelPos.axes[1] = screenRow;
+      for (pixelPos.axes[0] = start; pixelPos.axes[0] <= end; pixelPos.axes[0]++)
+	lcd_writeColor(layerProbe(layers, &pixelPos));
+    }
+  }
+}
+
+/* clips region to the screen; returns 0 if nothing is left */
+static int
+spriteClip(Region *clip)
+{
+  vec2Max(&clip->topLeft, &clip->topLeft, &vec2Zero);
+  clip->botRight.axes[0] = clip->botRight.axes[0] < screenWidth - 1 ? clip->botRight.axes[0] : screenWidth - 1;
+  clip->botRight.axes[1] = clip->botRight.axes[1] < screenHeight - 1 ? clip->botRight.axes[1] : screenHeight - 1;
+  return clip->topLeft.axes[0] <= clip->botRight.axes[0] &&
+    clip->topLeft.axes[1] <= clip->botRight.axes[1];
+}
+
+void
+spriteDraw(const Sprite *sprite, const Vec2 *centerPos, const Layer *layers)
+{
+  Region bounds, clip;
+  int row;
+  spriteGetBounds(sprite, centerPos, &bounds);
+  clip = bounds;
+  if (!spriteClip(&clip))
+    return;			/* off screen */
+
+  lcd_setArea(clip.topLeft.axes[0], clip.topLeft.axes[1],
+	      clip.botRight.axes[0], clip.botRight.axes[1]);
+  for (row = clip.topLeft.axes[1]; row <= clip.botRight.axes[1]; row++)
+    spriteDrawRowSpan(sprite, row - bounds.topLeft.axes[1], bounds.topLeft.axes[0],
+		      clip.topLeft.axes[0], clip.botRight.axes[0], row, layers);
+}
+
+void
+spritePlayerDraw(const SpritePlayer *player, const Layer *layers)
+{
+  spriteDraw(&player->anim->frames[player->frame], &player->pos, layers);
+}
+
+void
+spritePlayerAdvance(SpritePlayer *player, const Layer *layers)
+{
+  const SpriteAnim *anim = player->anim;
+  const u_char *diff = anim->diffs + anim->diffStart[player->frame];
+  const Sprite *sprite;
+  Region bounds, clip;
+
+  if (++player->frame >= anim->nFrames)
+    player->frame = 0;
+  sprite = &anim->frames[player->frame];
+  spriteGetBounds(sprite, &player->pos, &bounds);
+  clip = bounds;
+  if (!spriteClip(&clip))
+    return;			/* off screen */
+
+  for (; diff[0] != SPRITE_DIFF_END; diff += 3) { /* row, col, count */
+    int row = bounds.topLeft.axes[1] + diff[0];
+    int start = bounds.topLeft.axes[0] + diff[1];
+    int end = start + diff[2] - 1;
+    if (row < clip.topLeft.axes[1] || row > clip.botRight.axes[1])
+      continue;
+    if (start < clip.topLeft.axes[0])
+      start = clip.topLeft.axes[0];
+    if (end > clip.botRight.axes[0])
+      end = clip.botRight.axes[0];
+    if (start > end)
+      continue;
+    lcd_setArea(start, row, end, row);
+    spriteDrawRowSpan(sprite, diff[0], bounds.topLeft.axes[0], start, end, row, layers);
+  }
+}
@@ -0,0 +1,78 @@
+/** \file sprite.h
+ *  \brief Multi-color sprites stored as run-length encoded palette indices.
+ */
+
+#ifndef sprite_included
+#define sprite_included
+
+#include "shape.h"
+
+/** A run-length encoded sprite
+ *
+ *  Each row is a sequence of (length, palette index) byte pairs whose
+ *  lengths sum to width.  rowStart[row] is the offset in runs of the
+ *  row's first pair.  Pixels whose index is transparent show whatever
+ *  is beneath the sprite.
+ *
+ *  Sprites are normally generated from PPM images by makeSprite.
+ */
+typedef struct {
+  u_char width, height;
+  u_char transparent;		/* palette index that isn't drawn */
+  const u_int *palette;		/* BGR colors */
+  const u_char *runs;
+  const u_int *rowStart;
+} Sprite;
+
+/** Draws sprite centered at centerPos (like an AbShape).
+ *
+ *  Opaque runs are streamed to the LCD as color runs.  Only pixels in
+ *  transparent runs are composited, by probing layers.
+ *
+ *  \param layers (in) The layers beneath the sprite (may be 0 for bgColor)
+ */
+void spriteDraw(const Sprite *sprite, const Vec2 *centerPos, const Layer *layers);
+
+/** Computes sprite's screen region when centered at centerPos
+ */
+void spriteGetBounds(const Sprite *sprite, const Vec2 *centerPos, Region *bounds);
+
+/** Marks the end of a transition's diff list (no sprite has 255 rows) */
+#define SPRITE_DIFF_END 255
+
+/** An animation: equal-sized frames sharing one palette
+ *
+ *  diffs lists, for each transition from frame k to frame k+1 (the
+ *  last frame wraps to frame 0), the spans of the new frame whose
+ *  pixels differ from the old one as (row, col, count) byte triples
+ *  ending with SPRITE_DIFF_END.  diffStart[k] is the offset in diffs
+ *  of transition k's list.
+ *
+ *  makeSprite generates a SpriteAnim when given several images.
+ */
+typedef struct {
+  u_char nFrames;
+  const Sprite *frames;
+  const u_char *diffs;
+  const u_int *diffStart;
+} SpriteAnim;
+
+/** An animation playing at a fixed position */
+typedef struct {
+  const SpriteAnim *anim;
+  Vec2 pos;			/* center */
+  u_char frame;			/* currently displayed */
+} SpritePlayer;
+
+/** Draws player's current frame in full (e.g. after it moves)
+ */
+void spritePlayerDraw(const SpritePlayer *player, const Layer *layers);
+
+/** Advances player to its next frame, redrawing only the spans that
+ *  differ from the frame on screen.
+ *
+ *  Assumes the current frame is already drawn at player->pos.
+ */
+void spritePlayerAdvance(SpritePlayer *player, const Layer *layers);
+
+#endif // included
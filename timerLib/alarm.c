@@ -0,0 +1,96 @@
+#include <msp430.h>
+#include "critical.h"
+#include "isr.h"
+#include "timebase.h"
+#include "alarm.h"
+
+static Alarm *alarms;		/* pending, earliest first */
+
+/* unlinks alarm; interrupts must be off */
+static void
+alarmUnlink(Alarm *alarm)
+{
+  Alarm **pp;
+  for (pp = &alarms; *pp; pp = &(*pp)->next)
+    if (*pp == alarm) {
+      *pp = alarm->next;
+      break;
+    }
+  alarm->pending = 0;
+}
+
+/* programs CCR0 for the earliest alarm; returns 1 if it's already due.
+   Interrupts must be off. */
+static int
+alarmProgram()
+{
+  long remaining;
+  if (!alarms) {
+    TA1CCTL0 = 0;		/* nothing to wait for */
+    return 0;
+  }
+  remaining = alarms->deadline - timebaseNow();
+  if (remaining >= 0x10000) {	/* beyond this wrap: the overflow interrupt */
+    TA1CCTL0 = 0;		/* will reprogram when it's in range */
+    return 0;
+  }
+  TA1CCR0 = (unsigned int)alarms->deadline;
+  TA1CCTL0 = CCIE;
+  if ((long)(alarms->deadline - timebaseNow()) <= 0) /* passed while programming */
+    return 1;
+  return 0;
+}
+
+/* runs the handlers of due alarms, then reprograms CCR0 (interrupt
+   context); returns nonzero if a handler asked to wake the CPU */
+int
+alarmDispatch()
+{
+  int wake = 0;
+  ISR_TIME_BEGIN();
+  for (;;) {
+    while (alarms && (long)(alarms->deadline - timebaseNow()) <= 0) {
+      Alarm *due = alarms;
+      alarms = due->next;
+      due->pending = 0;
+      wake |= due->handler(due); /* may re-arm itself */
+    }
+    if (!alarmProgram()) {
+      ISR_TIME_END();
+      return wake;
+    }
+  }
+}
+
+void
+alarmSet(Alarm *alarm, unsigned long deadline)
+{
+  Alarm **pp;
+  CRIT_ENTER();
+  if (alarm->pending)
+    alarmUnlink(alarm);
+  alarm->deadline = deadline;
+  for (pp = &alarms; *pp && (long)((*pp)->deadline - deadline) <= 0; pp = &(*pp)->next)
+    ;				/* after alarms due no later */
+  alarm->next = *pp;
+  *pp = alarm;
+  alarm->pending = 1;
+  if (alarms == alarm && alarmProgram())
+    TA1CCTL0 |= CCIFG;		/* already due: interrupt at once */
+  CRIT_EXIT();
+}
+
+void
+alarmCancel(Alarm *alarm)
+{
+  CRIT_ENTER();
+  if (alarm->pending) {
+    alarmUnlink(alarm);
+    if (alarmProgram())
+      TA1CCTL0 |= CCIFG;	/* next is already due: interrupt at once */
+  }
+  CRIT_EXIT();
+}
+
+/* CCR0: the earliest alarm is due */
+ISR_TRAMPOLINE(TIMER1_A0, alarmDispatch, 0);
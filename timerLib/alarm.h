@@ -0,0 +1,28 @@
+#ifndef alarm_included
+#define alarm_included
+
+/** A deadline on the timebase (timebase.h) and what to do when it passes.
+ *
+ *  Pending alarms are kept sorted by deadline.  Only the earliest is
+ *  programmed into Timer A1's CCR0, so the CPU stays in low-power
+ *  mode until some alarm is actually due.
+ */
+typedef struct Alarm_s {
+  unsigned long deadline;	/* timebase ticks */
+  /** Called from the timer interrupt once deadline passes.
+   *  May re-arm the alarm (e.g. deadline + period) with alarmSet.
+   *  Returns nonzero to wake the CPU from low-power mode. */
+  int (*handler)(struct Alarm_s *alarm);
+  struct Alarm_s *next;		/* maintained by alarmSet */
+  unsigned char pending;	/* 1 while in the list */
+} Alarm;
+
+/** Schedules alarm (re-scheduling it if already pending).
+ *  A deadline that has already passed fires at once.
+ */
+void alarmSet(Alarm *alarm, unsigned long deadline);
+
+/** Removes alarm from the list if pending */
+void alarmCancel(Alarm *alarm);
+
+#endif // included
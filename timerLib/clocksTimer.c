@@ -1,18 +1,105 @@
 #include <msp430.h>
 #include "libTimer.h"
 
+/* DCO and dividers of each profile (indexed by ClockProfile) */
+static const struct {
+  unsigned char dco16;		/* 1: DCO at 16 MHz, 0: 8 MHz */
+  unsigned char bcs2;		/* MCLK & SMCLK dividers (source DCO) */
+  unsigned int timerId;		/* divides SMCLK to 2 MHz */
+  unsigned long mclkHz, smclkHz;
+} profiles[] = {
+  { 1, DIVM_0 | DIVS_3, ID_0, 16000000, 2000000 },  /* CLOCK_BALANCED */
+  { 1, DIVM_0 | DIVS_0, ID_3, 16000000, 16000000 }, /* CLOCK_MAX_SPI */
+  { 0, DIVM_2 | DIVS_2, ID_0, 2000000, 2000000 },   /* CLOCK_LOW_POWER */
+};
+
+static ClockProfile current = CLOCK_BALANCED;
+static ClockListener *listeners;
+
 void configureClocks(){
   WDTCTL = WDTPW + WDTHOLD;//Disable Watchdog Timer
-  BCSCTL1 = CALBC1_16MHZ;  // Set DCO to 16 Mhz
-  DCOCTL = CALDCO_16MHZ;
-    
-  BCSCTL2 &= ~(SELS);     // SMCLK source = DCO
-  BCSCTL2 |= DIVS_3;      // SMCLK = DCO / 8
+  clockSetProfile(CLOCK_BALANCED); // DCO 16 MHz, SMCLK = DCO / 8
+}
+
+int
+clockSetProfile(ClockProfile profile)
+{
+  ClockListener *l;
+  unsigned int id = profiles[profile].timerId, mc0, mc1;
+  if ((IE1 & WDTIE) && profiles[profile].smclkHz != profiles[current].smclkHz)
+    return 0;			/* would change the WDT interval */
+  for (l = listeners; l; l = l->next)
+    if (l->changing)
+      l->changing(l);
+  CRIT_ENTER();
+  /* halt the timers, setting their new dividers, until SMCLK has
+     changed too: they never count it with the wrong divider */
+  mc0 = TA0CTL & MC_3;
+  mc1 = TA1CTL & MC_3;
+  TA0CTL = (TA0CTL & ~(MC_3 | ID_3)) | id;
+  TA1CTL = (TA1CTL & ~(MC_3 | ID_3)) | id;
+  DCOCTL = 0;			/* lowest DCO tap while switching ranges */
+  if (profiles[profile].dco16) {
+    BCSCTL1 = CALBC1_16MHZ;
+    DCOCTL = CALDCO_16MHZ;
+  } else {
+    BCSCTL1 = CALBC1_8MHZ;
+    DCOCTL = CALDCO_8MHZ;
+  }
+  BCSCTL2 = profiles[profile].bcs2;
+  TA1CTL |= mc1;		/* restart: 2 MHz again */
+  TA0CTL |= mc0;
+  current = profile;
+  CRIT_EXIT();
+  for (l = listeners; l; l = l->next)
+    l->changed(l);
+  return 1;
+}
+
+ClockProfile
+clockGetProfile()
+{
+  return current;
+}
+
+void
+clockAddListener(ClockListener *listener)
+{
+  ClockListener *l;
+  for (l = listeners; l; l = l->next)
+    if (l == listener)		/* already added */
+      return;
+  listener->next = listeners;
+  listeners = listener;
+}
+
+unsigned long
+clockMclkHz()
+{
+  return profiles[current].mclkHz;
+}
+
+unsigned long
+clockSmclkHz()
+{
+  return profiles[current].smclkHz;
+}
+
+unsigned int
+clockWdtHz()
+{
+  return profiles[current].smclkHz / 8192;
+}
+
+unsigned int
+clockTimerId()
+{
+  return profiles[current].timerId;
 }
 
 
 // enable watchdog timer periodic interrupt
-// period = SMCLOCK/32k
+// period = SMCLOCK/8192 (see clockWdtHz; clockSetProfile then keeps SMCLK)
 void enableWDTInterrupts()  
 {
   WDTCTL = WDTPW |	   // passwd req'd.  Otherwise device resets
@@ -30,9 +117,7 @@ void timerAUpmode()
   TA0CCTL1 = OUTMOD_3;		/* Toggle p1.6 when timer=count1 */
   
   // Timer A control:
-  //  Timer clock source 2: system clock (SMCLK)
+  //  Timer clock source 2: system clock (SMCLK), divided to 2 MHz
   //  Mode Control 1: continuously 0...CCR0
-  TACTL = TASSEL_2 + MC_1;   
+  TACTL = TASSEL_2 + MC_1 + clockTimerId();
 }
-
-
@@ -1,7 +1,62 @@
 #ifndef timerLib_included
 #define timerLib_included
 
+/** Clock profiles: settings of the DCO and the MCLK & SMCLK dividers.
+ *
+ *  Whatever the profile, Timer A0 & A1 are divided down to count at
+ *  2 MHz, so the timebase (TIMEBASE_HZ), alarms and buzzer periods
+ *  keep their units.  Drivers that divide SMCLK themselves (the LCD's
+ *  SPI, the UART's baud rate) rescale from a ClockListener.
+ *
+ *  Switching halts both timers before the DCO or dividers change and
+ *  restarts them once SMCLK and their own dividers agree again, so
+ *  they never count at the wrong rate.  The timebase just falls
+ *  behind by the time they were halted: about ten instructions, i.e.
+ *  roughly 1-2 us (2-4 ticks) when switching to a 16 MHz MCLK, and up
+ *  to about 15 us (30 ticks) when switching to CLOCK_LOW_POWER's 2 MHz
+ *  MCLK, plus up to one tick of prescaler phase (only TACLR resets it,
+ *  and that would zero the timebase).  The loss never makes the
+ *  timebase jump forward, so alarms fire late, never early.
+ *
+ *  The WDT interval is SMCLK/8192, which no WDTIS setting can hold
+ *  constant across these profiles: while enableWDTInterrupts is in
+ *  effect, profiles with a different SMCLK are refused.
+ */
+typedef enum {
+  CLOCK_BALANCED,	/**< MCLK 16 MHz, SMCLK 2 MHz: SPI at 2 MHz (configureClocks) */
+  CLOCK_MAX_SPI,	/**< MCLK & SMCLK 16 MHz: SPI at 8 MHz, for rendering */
+  CLOCK_LOW_POWER	/**< DCO 8 MHz, MCLK & SMCLK 2 MHz: for idling */
+} ClockProfile;
+
+/** Told of profile changes (with interrupts enabled).
+ *
+ *  changing (may be 0) runs before the clocks are touched, so a driver
+ *  can finish or hold a transfer; changed runs once they are stable.
+ */
+typedef struct ClockListener_s {
+  void (*changed)(struct ClockListener_s *listener);
+  void (*changing)(struct ClockListener_s *listener);
+  struct ClockListener_s *next;	/* maintained by clockAddListener */
+} ClockListener;
+
+/** Stops the WDT and selects CLOCK_BALANCED */
 void configureClocks();
+
+/** Switches to profile, calling the listeners before and after.
+ *  Not from interrupt handlers.
+ *  \return 0 (and nothing changes) if the WDT interval would change
+ */
+int clockSetProfile(ClockProfile profile);
+ClockProfile clockGetProfile();
+
+/** Adds listener (once) to those told of profile changes */
+void clockAddListener(ClockListener *listener);
+
+unsigned long clockMclkHz();	/**< CPU clock */
+unsigned long clockSmclkHz();	/**< peripheral clock */
+unsigned int clockWdtHz();	/**< enableWDTInterrupts' interrupt rate */
+unsigned int clockTimerId();	/**< ID_x bits that divide SMCLK to 2 MHz */
+
 void enableWDTInterrupts();
 void timerAUpmode();
 
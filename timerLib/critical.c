@@ -0,0 +1,30 @@
+#include "timebase.h"
+#include "critical.h"
+
+CritStats critStats;
+
+static unsigned long start;	/* of the current outermost section */
+static const char *startFile;
+static unsigned int startLine;
+
+void
+critStatsBegin(const char *file, unsigned int line)
+{
+  startFile = file;
+  startLine = line;
+  start = timebaseNow();
+}
+
+void
+critStatsEnd()
+{
+  unsigned long ticks = timebaseNow() - start;
+  critStats.total += ticks;
+  if (ticks > critStats.worst) {
+    critStats.worst = ticks;
+    critStats.worstFile = startFile;
+    critStats.worstLine = startLine;
+  }
+  if (critStats.count != 0xffff)
+    critStats.count++;
+}
@@ -0,0 +1,103 @@
+#ifndef critical_included
+#define critical_included
+
+#include <msp430.h>
+
+/** Critical sections: code that must run with interrupts masked.
+ *
+ *      CRIT_ENTER();
+ *      ...                 shared with interrupt handlers
+ *      CRIT_EXIT();
+ *
+ *  CRIT_ENTER saves whether interrupts were enabled, then masks them;
+ *  CRIT_EXIT restores that state.  So sections nest (an inner
+ *  CRIT_EXIT leaves interrupts masked) and are harmless in interrupt
+ *  handlers.  Both expand inline, unlike and_sr/or_sr (sr.h).  Use
+ *  one pair per block.  CRIT_EXIT_SLEEP ends a section by sleeping
+ *  with interrupts enabled, but only if the section is outermost and
+ *  was entered with them enabled; otherwise it acts as CRIT_EXIT.
+ *
+ *  Compiled with -DCRIT_STATS ("make CRIT_STATS=1"), outermost
+ *  sections are timed on the timebase, and critStats records the
+ *  longest with its file & line: the worst interrupt latency they add.
+ */
+typedef unsigned int CritState;	/* GIE before CRIT_ENTER */
+
+typedef struct {
+  unsigned long total;		/* ticks interrupts were masked */
+  unsigned long worst;		/* longest section */
+  const char *worstFile;	/* where it began */
+  unsigned int worstLine;
+  unsigned int count;		/* sections timed (saturates) */
+} CritStats;
+
+extern CritStats critStats;
+
+void critStatsBegin(const char *file, unsigned int line);
+void critStatsEnd();
+
+static inline CritState
+critEnter()
+{
+  CritState state = __get_SR_register() & GIE;
+  __disable_interrupt();
+  return state;
+}
+
+static inline void
+critExit(CritState state)
+{
+  if (state)
+    __enable_interrupt();
+}
+
+static inline CritState
+critEnterTimed(const char *file, unsigned int line)
+{
+  CritState state = critEnter();
+  if (state)			/* outermost */
+    critStatsBegin(file, line);
+  return state;
+}
+
+static inline void
+critExitTimed(CritState state)
+{
+  if (state)
+    critStatsEnd();
+  critExit(state);
+}
+
+/* ends the section by enabling interrupts and sleeping (LPM0) in one
+   instruction, so an interrupt that makes work for main during the
+   section still wakes it (CRIT_EXIT_SLEEP).  Only an outermost section
+   entered with interrupts enabled may sleep: otherwise (nested, or
+   interrupts already masked) nothing could wake the CPU, so this just
+   ends the section like CRIT_EXIT and returns, leaving interrupts
+   masked, and the caller's loop polls instead */
+static inline void
+critExitSleep(CritState state)
+{
+  if (state)
+    __bis_SR_register(GIE | CPUOFF);
+}
+
+static inline void
+critExitSleepTimed(CritState state)
+{
+  if (state)
+    critStatsEnd();
+  critExitSleep(state);
+}
+
+#ifdef CRIT_STATS
+#define CRIT_ENTER() CritState critState = critEnterTimed(__FILE__, __LINE__)
+#define CRIT_EXIT() critExitTimed(critState)
+#define CRIT_EXIT_SLEEP() critExitSleepTimed(critState)
+#else
+#define CRIT_ENTER() CritState critState = critEnter()
+#define CRIT_EXIT() critExit(critState)
+#define CRIT_EXIT_SLEEP() critExitSleep(critState)
+#endif
+
+#endif // included
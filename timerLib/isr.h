@@ -0,0 +1,71 @@
+#ifndef isr_included
+#define isr_included
+
+/** Interrupt vector numbers (the N of __interrupt_vector_N, as in
+ *  msp430g2553.h's *_VECTOR) for ISR_TRAMPOLINE
+ */
+#define ISR_VEC_PORT1 3
+#define ISR_VEC_PORT2 4
+#define ISR_VEC_USCIAB0TX 7
+#define ISR_VEC_USCIAB0RX 8
+#define ISR_VEC_TIMER0_A1 9
+#define ISR_VEC_TIMER0_A0 10
+#define ISR_VEC_WDT 11
+#define ISR_VEC_TIMER1_A1 13
+#define ISR_VEC_TIMER1_A0 14
+
+#define ISR_STR(x) #x
+#define ISR_XSTR(x) ISR_STR(x)
+
+/** Installs an assembly entry point for vector (e.g. WDT) that calls
+ *  "int handler()" and returns from the interrupt.
+ *
+ *  It saves only R11-R15, the registers a C function may clobber;
+ *  the handler saves any others it uses (a compiler-generated
+ *  interrupt prologue saves more).  If the handler returns
+ *  nonzero, the CPU wakes from low-power mode on return (all LPM bits
+ *  are cleared in the saved SR).
+ *
+ *  If nested is 1, interrupts are re-enabled before calling the
+ *  handler so a long handler doesn't delay the others.  Only use it
+ *  for vectors whose flag clears when the interrupt is taken (WDT,
+ *  a timer's CCR0), or it fires again at once.  The libraries assume
+ *  handlers do not nest, so a nested handler must not (outside
+ *  CRIT_ENTER/CRIT_EXIT, critical.h):
+ *   - call p2sw_poll: the PORT2 handler also pushes to the switch ring
+ *   - move layers (mlAdvance, mlPublish): mlSeq has a single writer
+ *   - use ISR_TIME_BEGIN/END (timebase.h): isrTicks += is not atomic
+ *  The handler must not be static.  Use once per vector, at file scope.
+ */
+#define ISR_TRAMPOLINE(vector, handler, nested)				\
+  __asm__(".pushsection __interrupt_vector_" ISR_XSTR(ISR_VEC_##vector)	\
+	  ",\"ax\",@progbits\n"						\
+	  "	.word	isr_" #vector "\n"				\
+	  "	.popsection\n"						\
+	  "	.pushsection .text\n"					\
+	  "	.global	isr_" #vector "\n"				\
+	  "	.p2align 1\n"						\
+	  "isr_" #vector ":\n"						\
+	  "	push	r15\n"						\
+	  "	push	r14\n"						\
+	  "	push	r13\n"						\
+	  "	push	r12\n"						\
+	  "	push	r11\n"						\
+	  "	.if " #nested "\n"					\
+	  "	eint\n"							\
+	  "	nop\n"							\
+	  "	.endif\n"						\
+	  "	call	#" #handler "\n"				\
+	  "	tst	r12\n"						\
+	  "	jz	1f\n"						\
+	  "	bic	#0xf0, 10(r1)\n" /* wake: LPM bits off in saved SR */	\
+	  "1:	pop	r11\n"						\
+	  "	pop	r12\n"						\
+	  "	pop	r13\n"						\
+	  "	pop	r14\n"						\
+	  "	pop	r15\n"						\
+	  "	reti\n"							\
+	  "	.size	isr_" #vector ", .-isr_" #vector "\n"		\
+	  "	.popsection\n")
+
+#endif // included
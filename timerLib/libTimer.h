@@ -3,5 +3,12 @@
 
 #include "clocksTimer.h"
 #include "sr.h"
+#include "critical.h"
+#include "isr.h"
+#include "timebase.h"
+#include "alarm.h"
+#include "sched.h"
+#include "profile.h"
+#include "pcsample.h"
 
 #endif // included
@@ -0,0 +1,57 @@
+#include <msp430.h>
+#include "timebase.h"
+#include "pcsample.h"
+
+unsigned char pcSampleBins[PCSAMPLE_BINS];
+unsigned int pcSampleOther;
+unsigned char pcSampleHalvings;
+
+static unsigned int period;
+
+/* timebaseSampler: bins pc and schedules the next sample */
+static int
+pcSample(unsigned int pc)
+{
+  TA1CCR2 += period;
+  if (pc < PCSAMPLE_BASE) {
+    if (pcSampleOther != 0xffff)
+      pcSampleOther++;
+  } else {
+    unsigned char *bin = &pcSampleBins[(pc - PCSAMPLE_BASE) >> PCSAMPLE_SHIFT];
+    if (*bin == 0xff) {		/* full: halve every bin */
+      unsigned char *b;
+      for (b = pcSampleBins; b < pcSampleBins + PCSAMPLE_BINS; b++)
+	*b >>= 1;
+      pcSampleHalvings++;
+    }
+    (*bin)++;
+  }
+  return 0;			/* let the CPU sleep on */
+}
+
+void
+pcSampleStart(unsigned int samplePeriod)
+{
+  unsigned char *b;
+  pcSampleStop();
+  for (b = pcSampleBins; b < pcSampleBins + PCSAMPLE_BINS; b++)
+    *b = 0;
+  pcSampleOther = 0;
+  pcSampleHalvings = 0;
+  period = samplePeriod;
+  timebaseSampler = pcSample;
+  pcSampleResume();
+}
+
+void
+pcSampleResume()
+{
+  TA1CCR2 = TA1R + period;
+  TA1CCTL2 = CCIE;
+}
+
+void
+pcSampleStop()
+{
+  TA1CCTL2 = 0;
+}
@@ -0,0 +1,41 @@
+#ifndef pcsample_included
+#define pcsample_included
+
+/** Statistical profiler: Timer A1's CCR2 interrupt samples the
+ *  interrupted PC every period ticks and counts it in one of
+ *  PCSAMPLE_BINS bins of 2^PCSAMPLE_SHIFT bytes spanning flash.
+ *
+ *  Counts are bytes; when one would overflow, every bin is halved,
+ *  so the histogram keeps its proportions.  Samples taken in
+ *  low-power mode land just after the instruction that slept (in
+ *  schedRun or the main loop), which measures idle time.
+ *  Print the histogram with uart_pcsample_dump (uartLib) and map
+ *  the bins to functions with pcsample.py.
+ */
+#ifndef PCSAMPLE_SHIFT
+#define PCSAMPLE_SHIFT 7	/**< 128-byte bins */
+#endif
+
+#define PCSAMPLE_BASE 0xc000	/**< start of the g2553's 16 KB of flash */
+#define PCSAMPLE_BINS (0x4000 >> PCSAMPLE_SHIFT)
+
+extern unsigned char pcSampleBins[PCSAMPLE_BINS];
+extern unsigned int pcSampleOther;  /**< PCs outside flash (saturates) */
+extern unsigned char pcSampleHalvings; /**< times the bins were halved */
+
+/** Clears the histogram and samples every period timebase ticks.
+ *  Needs timebaseInit().  A period that isn't a multiple of other
+ *  activity's (e.g. a prime) avoids aliasing with it.
+ */
+void pcSampleStart(unsigned int period);
+
+/** Stops sampling; the histogram is kept */
+void pcSampleStop();
+
+/** Resumes sampling after pcSampleStop, adding to the histogram */
+void pcSampleResume();
+
+/** Nonzero while sampling */
+#define pcSampling() (TA1CCTL2 & CCIE)
+
+#endif // included
@@ -0,0 +1,56 @@
+#include "critical.h"
+#include "timebase.h"
+#include "profile.h"
+
+ProfileEntry profileTable[PROFILE_SECTIONS];
+
+static unsigned int overhead;	/* ticks an empty section measures */
+
+void
+profileReset()
+{
+  ProfileEntry *e;
+  overhead = 0;
+  for (e = profileTable; e < profileTable + PROFILE_SECTIONS; e++) {
+    e->total = e->min = e->max = 0;
+    e->count = 0;
+    e->depth = 0;
+  }
+  profileBegin(0);		/* time an empty section */
+  profileEnd(0);
+  overhead = profileTable[0].total;
+  profileTable[0].total = profileTable[0].min = profileTable[0].max = 0;
+  profileTable[0].count = 0;
+}
+
+void
+profileBegin(unsigned char id)
+{
+  ProfileEntry *e = &profileTable[id];
+  CRIT_ENTER();
+  if (!e->depth++)		/* outermost pass */
+    e->start = timebaseNow();
+  CRIT_EXIT();
+}
+
+void
+profileEnd(unsigned char id)
+{
+  unsigned long now = timebaseNow(), ticks;
+  ProfileEntry *e = &profileTable[id];
+  CRIT_ENTER();
+  if (!e->depth || --e->depth) { /* unmatched, or an inner pass */
+    CRIT_EXIT();
+    return;
+  }
+  ticks = now - e->start;
+  ticks = ticks > overhead ? ticks - overhead : 0;
+  e->total += ticks;
+  if (!e->count || ticks < e->min)
+    e->min = ticks;
+  if (ticks > e->max)
+    e->max = ticks;
+  if (e->count != 0xffff)
+    e->count++;
+  CRIT_EXIT();
+}
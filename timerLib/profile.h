@@ -0,0 +1,63 @@
+#ifndef profile_included
+#define profile_included
+
+/** Section profiling on the timebase (see timebase.h).
+ *
+ *  PROFILE_BEGIN(id) ... PROFILE_END(id) brackets a section of code;
+ *  every pass adds its duration, in timebase ticks (TIMEBASE_CYCLES
+ *  CPU cycles each), to profileTable[id].  The macros expand to
+ *  nothing unless the file is compiled with -DPROFILE ("make
+ *  PROFILE=1" from the top directory builds the libraries that way),
+ *  so instrumentation costs neither time nor RAM in normal builds.
+ *
+ *  The table can be read with the debugger ("md profileTable") or
+ *  from the program.  Durations include time spent in interrupt
+ *  handlers that preempt the section; the cost of the timestamps
+ *  themselves is measured by profileReset() (which timebaseInit calls
+ *  in PROFILE builds) and subtracted.  A section entered again before
+ *  it ends (e.g. from an interrupt handler) is timed only by the
+ *  outermost pass, which includes the inner one.
+ */
+
+/** Section ids.  Applications number their own from PROFILE_APP. */
+enum {
+  PROFILE_LAYER_DRAW,		/**< layerDraw (whole screen) */
+  PROFILE_MOVLAYER_DRAW,	/**< movLayerDraw */
+  PROFILE_ML_ADVANCE,		/**< mlAdvance */
+  PROFILE_DRAW_CHAR,		/**< drawChar5x7 */
+  PROFILE_DRAW_STRING,		/**< drawString5x7 */
+  PROFILE_APP			/**< first id free for applications */
+};
+
+#ifndef PROFILE_SECTIONS
+#define PROFILE_SECTIONS 8	/**< size of profileTable */
+#endif
+
+/** Accumulated timings of one section, in timebase ticks */
+typedef struct {
+  unsigned long total;
+  unsigned long min, max;	/* min is set by the first pass */
+  unsigned int count;		/* passes (saturates) */
+  unsigned long start;		/* while in the section */
+  unsigned char depth;		/* passes begun but not ended */
+} ProfileEntry;
+
+extern ProfileEntry profileTable[PROFILE_SECTIONS];
+
+/** Clears the table and calibrates the timestamp overhead.
+ *  timebaseInit() calls it in PROFILE builds; call it again to restart.
+ */
+void profileReset();
+
+void profileBegin(unsigned char id);
+void profileEnd(unsigned char id);
+
+#ifdef PROFILE
+#define PROFILE_BEGIN(id) profileBegin(id)
+#define PROFILE_END(id) profileEnd(id)
+#else
+#define PROFILE_BEGIN(id) ((void)0)
+#define PROFILE_END(id) ((void)0)
+#endif
+
+#endif // included
@@ -0,0 +1,68 @@
+#include <msp430.h>
+#include "critical.h"
+#include "timebase.h"
+#include "sched.h"
+
+static Task *readyTasks;	/* by priority, then posting order */
+unsigned long schedIdleTicks;
+
+int
+taskPost(Task *task)
+{
+  Task **pp;
+  CRIT_ENTER();
+  if (!task->ready) {
+    for (pp = &readyTasks; *pp && (*pp)->priority <= task->priority; pp = &(*pp)->next)
+      ;				/* after tasks at least as urgent */
+    task->next = *pp;
+    *pp = task;
+    task->ready = 1;
+  }
+  CRIT_EXIT();
+  return 1;
+}
+
+void
+schedRun()
+{
+  __enable_interrupt();
+  for (;;) {
+    Task *task;
+    CRIT_ENTER();
+    task = readyTasks;
+    if (!task) {
+      unsigned long slept = timebaseNow();
+      CRIT_EXIT_SLEEP();	/* GIE & CPU off together: no wakeup is lost */
+      schedIdleTicks += timebaseNow() - slept;
+      continue;
+    }
+    readyTasks = task->next;
+    task->ready = 0;
+    CRIT_EXIT();
+    task->run(task);
+  }
+}
+
+/* alarm handler (interrupt context): post the timer's task */
+static int
+timerExpired(Alarm *alarm)
+{
+  SoftTimer *timer = (SoftTimer *)alarm;
+  if (timer->period)
+    alarmSet(alarm, alarm->deadline + timer->period);
+  return taskPost(timer->task);	/* wake to run it */
+}
+
+void
+timerStart(SoftTimer *timer, unsigned long delay, unsigned long period)
+{
+  timer->alarm.handler = timerExpired;
+  timer->period = period;
+  alarmSet(&timer->alarm, timebaseNow() + delay);
+}
+
+void
+timerStop(SoftTimer *timer)
+{
+  alarmCancel(&timer->alarm);
+}
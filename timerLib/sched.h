@@ -0,0 +1,53 @@
+#ifndef sched_included
+#define sched_included
+
+#include "alarm.h"
+
+/** A run-to-completion task.
+ *
+ *  Posting a task makes it ready.  schedRun() runs ready tasks one at
+ *  a time, lowest priority number first (first posted first among
+ *  equals).  A task posted again before it runs still runs once.
+ */
+typedef struct Task_s {
+  void (*run)(struct Task_s *task);
+  unsigned char priority;	/* 0 is most urgent */
+  unsigned char ready;		/* maintained by taskPost & schedRun */
+  struct Task_s *next;		/* in the ready queue */
+} Task;
+
+/** Makes task ready.  Safe to call from interrupt handlers.
+ *
+ *  An interrupt handler that posts a task must wake the CPU as it
+ *  returns (e.g. an alarm or switch handler returns nonzero).
+ *  \return 1, so that such handlers can "return taskPost(&task);"
+ */
+int taskPost(Task *task);
+
+/** Runs ready tasks forever.  Sleeps in LPM0 whenever none are ready.
+ *  Enables interrupts.
+ */
+void schedRun();
+
+/** Timebase ticks schedRun has spent asleep (including interrupt
+ *  handlers that ran meanwhile).  Programs with their own idle loop
+ *  may add to it too.
+ */
+extern unsigned long schedIdleTicks;
+
+/** A software timer that posts task when it expires */
+typedef struct {
+  Alarm alarm;			/* must be first */
+  Task *task;
+  unsigned long period;		/* timebase ticks; 0 for one-shot */
+} SoftTimer;
+
+/** Starts timer: its task is posted after delay ticks, then every
+ *  period ticks (or just once if period is 0).  Needs timebaseInit().
+ */
+void timerStart(SoftTimer *timer, unsigned long delay, unsigned long period);
+
+/** Stops timer */
+void timerStop(SoftTimer *timer);
+
+#endif // included
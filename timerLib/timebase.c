@@ -0,0 +1,34 @@
+#include <msp430.h>
+#include "clocksTimer.h"
+#include "timebase.h"
+#include "profile.h"
+
+/* timebaseIsr.s counts overflows of TA1R here, running alarmDispatch
+   (alarm.c) after each, and passes CCR2 interrupts to timebaseSampler */
+extern volatile unsigned int timebaseHigh;
+
+int (*timebaseSampler)(unsigned int pc);
+unsigned long isrTicks;
+
+void
+timebaseInit()
+{
+  timebaseHigh = 0;
+  TA1CTL = TASSEL_2 | clockTimerId() | MC_2 | TACLR | TAIE; /* SMCLK to 2 MHz, continuous */
+#ifdef PROFILE
+  profileReset();		/* measure the timestamps' overhead */
+#endif
+}
+
+unsigned long
+timebaseNow()
+{
+  unsigned int high, low;
+  do {				/* retry if an overflow was counted meanwhile */
+    high = timebaseHigh;
+    low = TA1R;
+  } while (high != timebaseHigh);
+  if ((TA1CTL & TAIFG) && low < 0x8000)
+    high++;			/* wrapped, but the interrupt hasn't run yet */
+  return ((unsigned long)high << 16) | low;
+}
@@ -0,0 +1,50 @@
+#ifndef timebase_included
+#define timebase_included
+
+/** Timer A1 counts continuously at 2 MHz, 0.5us per tick, in every
+ *  clock profile (clocksTimer.h divides SMCLK to suit), i.e. one tick
+ *  per 8 CPU cycles at 16 MHz -- fine enough to profile short routines.
+ *
+ *  The 16-bit count is extended to 32 bits by its overflow
+ *  interrupt, which fires every 32.8 ms: about 30 wakeups a second,
+ *  even when idle, where SMCLK/8 (4 us ticks) would need only 4.  That
+ *  is the price of the resolution (and 2 MHz is the slowest rate that
+ *  Timer A's /8 divider reaches from CLOCK_MAX_SPI's 16 MHz SMCLK).
+ *  Each overflow costs a few dozen cycles, and skips alarmDispatch
+ *  while CCR0 already holds the earliest alarm.  Timer A0 is left for
+ *  the buzzer.
+ */
+#define TIMEBASE_HZ 2000000UL
+
+/** CPU (MCLK) cycles per timebase tick, at 16 MHz (not CLOCK_LOW_POWER) */
+#define TIMEBASE_CYCLES 8
+
+/** Converts milliseconds to timebase ticks */
+#define TIMEBASE_MS(ms) ((unsigned long)(ms) * (TIMEBASE_HZ / 1000))
+
+/** Starts the timebase.  Call after configureClocks(). */
+void timebaseInit();
+
+/** Called from Timer A1's CCR2 interrupt with the interrupted PC.
+ *  Returns nonzero to wake the CPU.  Set by pcSampleStart.
+ */
+extern int (*timebaseSampler)(unsigned int pc);
+
+/** Ticks spent in interrupt handlers bracketed by ISR_TIME_BEGIN and
+ *  ISR_TIME_END (alarms, switches, UART transmit).  Counted only by
+ *  files compiled with -DFRAME_STATS ("make FRAME_STATS=1").
+ */
+extern unsigned long isrTicks;
+
+#ifdef FRAME_STATS
+#define ISR_TIME_BEGIN() unsigned long isrStart = timebaseNow()
+#define ISR_TIME_END() (isrTicks += timebaseNow() - isrStart)
+#else
+#define ISR_TIME_BEGIN()
+#define ISR_TIME_END() ((void)0)
+#endif
+
+/** Ticks since timebaseInit (wraps after about 36 minutes) */
+unsigned long timebaseNow();
+
+#endif // included
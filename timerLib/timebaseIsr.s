@@ -0,0 +1,51 @@
+	.arch msp430g2553
+	.p2align 1,0
+	.global	timebaseIsr
+	.section	__interrupt_vector_13,"ax",@progbits
+	.word	timebaseIsr
+	.text
+
+	;; Timer A1 overflow & CCR2 interrupt (TIMER1_A1_VECTOR).
+	;; In assembly so the PC-sampling profiler (pcsample.c)
+	;; can be handed the interrupted PC from the stack.
+
+	.global	timebaseHigh
+	.extern	alarmDispatch
+	.extern	timebaseSampler
+
+timebaseIsr:
+	push	r15		; registers C functions may clobber
+	push	r14
+	push	r13
+	push	r12
+	push	r11
+	mov	&TA1IV, r12	; highest pending source; reading clears it
+	cmp	#10, r12	; TA1IV_TAIFG
+	jeq	overflow
+	cmp	#4, r12		; TA1IV_TACCR2
+	jne	done
+	mov	12(r1), r12	; interrupted PC (above 5 regs & the SR)
+	call	&timebaseSampler
+	jmp	wake
+overflow:
+	inc	&timebaseHigh	; extend the count
+	bit	#0x10, &TA1CCTL0 ; CCIE: the earliest alarm is already on CCR0
+	jnz	done
+	call	#alarmDispatch	; far-off alarms may now be in range
+wake:
+	tst	r12		; nonzero: wake the CPU
+	jz	done
+	bic	#0x10, 10(r1)	; clear CPUOFF in saved SR
+done:
+	pop	r11
+	pop	r12
+	pop	r13
+	pop	r14
+	pop	r15
+	reti
+	.size	timebaseIsr, .-timebaseIsr
+
+	.bss
+	.balign 2
+timebaseHigh:			; overflows of TA1R
+	.skip	2
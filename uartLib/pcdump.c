@@ -0,0 +1,30 @@
+#include <msp430.h>
+#include "pcsample.h"
+#include "uart.h"
+
+void
+uart_pcsample_dump()
+{
+  unsigned int i;
+  unsigned char sampling = pcSampling();
+  pcSampleStop();		/* don't profile the dump */
+  uart_puts("pcsample base=");
+  uart_put_hex(PCSAMPLE_BASE, 4);
+  uart_puts(" shift=");
+  uart_put_dec(PCSAMPLE_SHIFT);
+  uart_puts(" halvings=");
+  uart_put_dec(pcSampleHalvings);
+  uart_puts(" other=");
+  uart_put_dec(pcSampleOther);
+  uart_puts("\r\n");
+  for (i = 0; i < PCSAMPLE_BINS; i++)
+    if (pcSampleBins[i]) {
+      uart_put_hex(PCSAMPLE_BASE + (i << PCSAMPLE_SHIFT), 4);
+      uart_putc(' ');
+      uart_put_dec(pcSampleBins[i]);
+      uart_puts("\r\n");
+    }
+  uart_puts("end\r\n");
+  if (sampling)
+    pcSampleResume();
+}
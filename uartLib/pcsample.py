@@ -0,0 +1,166 @@
+#!/usr/bin/env python3
+"""Maps a PC-sampling histogram (uart_pcsample_dump) to function names.
+
+usage: pcsample.py program.elf [dump]
+       pcsample.py --nm listing [dump]
+       pcsample.py --selftest
+
+dump is a file or serial device holding the board's output (default:
+standard input), e.g. after "stty -F /dev/ttyACM0 9600 raw":
+
+    ./pcsample.py ../shape-motion-demo/shapemotion.elf /dev/ttyACM0
+
+Lines before "pcsample ..." are ignored and reading stops at "end".
+Symbols come from msp430-elf-nm, or from a saved "msp430-elf-nm -n -S
+--defined-only" listing given with --nm.  A bin that spans several
+functions is shared between them in proportion to the bytes of each it
+covers.
+
+--selftest runs a saved dump and nm listing (testdata/pcsample.*)
+through the script and compares its report with the expected one, to
+check it without a board or toolchain.
+"""
+
+import argparse
+import difflib
+import os
+import subprocess
+import sys
+
+NM = "msp430-elf-nm"
+TESTDATA = os.path.join(os.path.dirname(os.path.abspath(__file__)), "testdata")
+
+
+def read_dump(f):
+    """Returns (base, shift, halvings, other, {bin address: count})."""
+    header = None
+    bins = {}
+    for line in f:
+        words = line.decode("ascii", "replace").split()
+        if not words:
+            continue
+        if words[0] == "pcsample":
+            fields = dict(w.split("=") for w in words[1:])
+            header = (int(fields["base"], 16), int(fields["shift"]),
+                      int(fields["halvings"]), int(fields["other"]))
+            bins = {}
+        elif header is None:
+            continue
+        elif words[0] == "end":
+            return header + (bins,)
+        else:
+            bins[int(words[0], 16)] = int(words[1])
+    sys.exit("pcsample.py: no complete dump found")
+
+
+def read_symbols(elf):
+    """Returns [(start, end, name)] of the program's code, by address."""
+    out = subprocess.run([NM, "-n", "-S", "--defined-only", elf],
+                         check=True, capture_output=True, text=True).stdout
+    return parse_symbols(out)
+
+
+def parse_symbols(out):
+    """Returns [(start, end, name)] of the code in an nm -n -S listing."""
+    syms = []
+    for line in out.splitlines():
+        words = line.split()
+        if len(words) == 4:
+            addr, size, kind, name = words
+            size = int(size, 16)
+        elif len(words) == 3:
+            addr, kind, name = words
+            size = None
+        else:
+            continue
+        if kind in "tTwW":
+            syms.append([int(addr, 16), size, name])
+    code = []
+    for i, (addr, size, name) in enumerate(syms):
+        if size is None:        # assembly without .size: up to the next one
+            size = syms[i + 1][0] - addr if i + 1 < len(syms) else 2
+        if size:
+            code.append((addr, addr + size, name))
+    return code
+
+
+def attribute(bins, binsize, syms):
+    """Returns {name: samples}, sharing each bin among its functions."""
+    samples = {}
+    for addr, count in bins.items():
+        end = addr + binsize
+        overlaps = [(min(end, e) - max(addr, s), name)
+                    for s, e, name in syms if s < end and e > addr]
+        covered = sum(n for n, _ in overlaps)
+        if covered < binsize:
+            overlaps.append((binsize - covered, "?"))
+        for n, name in overlaps:
+            samples[name] = samples.get(name, 0) + count * n / binsize
+    return samples
+
+
+def report(dump, syms):
+    """Returns the report on dump (as read_dump returns) as text."""
+    base, shift, halvings, other, bins = dump
+    samples = attribute(bins, 1 << shift, syms)
+    total = sum(samples.values())
+    lines = ["%d samples in %d bins of %d bytes from %04x"
+             % (round(total), len(bins), 1 << shift, base)]
+    if halvings:
+        lines[0] += " (scaled down by 2^%d)" % halvings
+    lines[0] += ", %d outside flash" % other
+    for name, n in sorted(samples.items(), key=lambda kv: (-kv[1], kv[0])):
+        lines.append("%7.1f %5.1f%%  %s" % (n, 100 * n / total, name))
+    return "\n".join(lines) + "\n"
+
+
+def selftest():
+    """Checks the report on the saved dump against the expected one."""
+    def path(name):
+        return os.path.join(TESTDATA, "pcsample." + name)
+    with open(path("dump"), "rb") as f:
+        dump = read_dump(f)
+    with open(path("nm")) as f:
+        syms = parse_symbols(f.read())
+    with open(path("expected")) as f:
+        expected = f.read()
+    got = report(dump, syms)
+    if got != expected:
+        sys.stdout.writelines(difflib.unified_diff(
+            expected.splitlines(True), got.splitlines(True),
+            "expected", "got"))
+        sys.exit("selftest: report differs")
+    print("selftest: %d bins, %d report lines ok"
+          % (len(dump[4]), len(expected.splitlines())), file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("elf", nargs="?", help="the profiled program")
+    parser.add_argument("dump", nargs="?", help="device or file (default stdin)")
+    parser.add_argument("--nm", help="saved nm -n -S listing (instead of the elf)")
+    parser.add_argument("--selftest", action="store_true",
+                        help="check against testdata/pcsample.*")
+    args = parser.parse_args()
+    if args.selftest:
+        selftest()
+        return
+    if args.elf is None and args.nm is None:
+        parser.error("a program (or --nm listing) is required")
+    if args.nm and args.dump is None:
+        args.dump = args.elf    # "--nm listing [dump]": no program
+    if args.nm:
+        with open(args.nm) as f:
+            syms = parse_symbols(f.read())
+    else:
+        syms = read_symbols(args.elf)
+    if args.dump:
+        with open(args.dump, "rb") as f:
+            dump = read_dump(f)
+    else:
+        dump = read_dump(sys.stdin.buffer)
+    sys.stdout.write(report(dump, syms))
+
+
+if __name__ == "__main__":
+    main()
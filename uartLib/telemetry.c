@@ -0,0 +1,53 @@
+#include "lcdutils.h"
+#include "p2switches.h"
+#include "framestats.h"
+#include "uart.h"
+
+static unsigned char dropped;	/* frames lost since the last one sent */
+static unsigned int lastEvents;
+
+/* stores v little-endian at p */
+static void
+put16(unsigned char *p, unsigned int v)
+{
+  p[0] = v;
+  p[1] = v >> 8;
+}
+
+static void
+put32(unsigned char *p, unsigned long v)
+{
+  put16(p, v);
+  put16(p + 2, v >> 16);
+}
+
+/* v, or 0xffff if it doesn't fit in 16 bits */
+static unsigned int
+sat16(unsigned long v)
+{
+  return v > 0xffff ? 0xffff : v;
+}
+
+void
+telemetry_send()
+{
+  unsigned char f[TELEMETRY_LEN], sum = 0, i;
+  f[0] = 0xa5;
+  f[1] = 0x5a;
+  put16(f + 2, frameStats.frame);
+  put32(f + 4, frameStats.ticks);
+  put32(f + 8, frameStats.busyTicks);
+  put16(f + 12, sat16(frameStats.pixels));
+  put16(f + 14, sat16(frameStats.spiBytes));
+  put16(f + 16, sat16(frameStats.isrTicks));
+  f[18] = p2sw_events - lastEvents;
+  f[19] = dropped;
+  for (i = 2; i < TELEMETRY_LEN - 1; i++)
+    sum += f[i];
+  f[TELEMETRY_LEN - 1] = sum;
+  if (uart_write(f, TELEMETRY_LEN)) {
+    lastEvents = p2sw_events;	/* events of dropped frames carry over */
+    dropped = 0;
+  } else if (dropped != 0xff)
+    dropped++;
+}
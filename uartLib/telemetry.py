@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Decodes the telemetry frames sent by telemetry_send() (uart.h).
+
+usage: telemetry.py [options] [source]
+
+source is a serial device or file holding the board's output (default:
+standard input), e.g. after "stty -F /dev/ttyACM0 9600 raw":
+
+    ./telemetry.py --csv soak.csv /dev/ttyACM0
+
+Each frame becomes a CSV row; rolling statistics over the last
+--window frames are printed to stderr every --window frames.
+
+--loopback runs the decoder against a pseudo-terminal fed with
+synthetic frames (including a corrupted one), to check the decoder
+without a board.
+"""
+
+import argparse
+import collections
+import os
+import random
+import struct
+import sys
+import threading
+import tty
+
+SYNC = b"\xa5\x5a"
+BODY = struct.Struct("<HLLHHHBB")   # bytes 2..19 of a frame
+LEN = 2 + BODY.size + 1             # TELEMETRY_LEN
+FIELDS = ("frame", "ticks", "busy", "pixels", "spi_bytes", "isr_ticks",
+          "events", "dropped")
+
+
+def frames(stream):
+    """Yields (fields, skipped bytes) for each valid frame in stream."""
+    buf = b""
+    skipped = 0
+    while True:
+        chunk = stream.read(256)
+        if not chunk:
+            return
+        buf += chunk
+        while len(buf) >= LEN:
+            if buf[:2] != SYNC or sum(buf[2:LEN - 1]) & 0xff != buf[LEN - 1]:
+                buf = buf[1:]            # resynchronize
+                skipped += 1
+                continue
+            yield dict(zip(FIELDS, BODY.unpack(buf[2:LEN - 1]))), skipped
+            buf = buf[LEN:]
+            skipped = 0
+
+
+class Rolling:
+    """Statistics over the last n frames."""
+
+    def __init__(self, n, hz):
+        self.window = collections.deque(maxlen=n)
+        self.hz = hz
+        self.lost = self.bad = 0
+        self.last = None
+
+    def add(self, f, skipped):
+        if skipped:
+            self.bad += 1
+        if self.last is not None:
+            gap = (f["frame"] - self.last - 1) & 0xffff
+            self.lost += gap             # frames not sent or not received
+        self.last = f["frame"]
+        self.window.append(f)
+
+    def report(self):
+        w = [f for f in self.window if f["ticks"]]
+        if not w:
+            return "no frames"
+        ticks = sum(f["ticks"] for f in w)
+        loads = [100 * f["busy"] / f["ticks"] for f in w]
+        return ("frames %d-%d: %.1f fps, load %.0f%% (max %.0f%%), "
+                "%.0f px, %.0f SPI B, isr %.1f%%, %d events, "
+                "%d lost, %d bad"
+                % (w[0]["frame"], w[-1]["frame"], len(w) * self.hz / ticks,
+                   100 * sum(f["busy"] for f in w) / ticks, max(loads),
+                   sum(f["pixels"] for f in w) / len(w),
+                   sum(f["spi_bytes"] for f in w) / len(w),
+                   100 * sum(f["isr_ticks"] for f in w) / ticks,
+                   sum(f["events"] for f in w), self.lost, self.bad))
+
+
+def decode(stream, csv, window, hz, limit=None):
+    """Decodes frames from stream (until limit); returns how many."""
+    stats = Rolling(window, hz)
+    csv.write(",".join(FIELDS) + "\n")
+    n = 0
+    for f, skipped in frames(stream):
+        csv.write(",".join(str(f[k]) for k in FIELDS) + "\n")
+        stats.add(f, skipped)
+        n += 1
+        if n % window == 0:
+            csv.flush()
+            print(stats.report(), file=sys.stderr)
+        if n == limit:
+            break
+    if n % window:
+        print(stats.report(), file=sys.stderr)
+    return n
+
+
+def encode(frame, ticks, busy, pixels, spi, isr, events, dropped):
+    body = BODY.pack(frame, ticks, busy, pixels, spi, isr, events, dropped)
+    return SYNC + body + bytes([sum(body) & 0xff])
+
+
+def loopback(args):
+    """Feeds synthetic frames through a pty to the decoder."""
+    master, slave = os.openpty()
+    tty.setraw(slave)                            # no line discipline
+    count = args.frames
+
+    def board():
+        rng = random.Random(1)
+        for i in range(count):
+            ticks = 120000                       # 60 ms at 2 MHz
+            data = encode(i, ticks, rng.randrange(20000, 40000),
+                          rng.randrange(1000, 3000), rng.randrange(2000, 6000),
+                          rng.randrange(500, 1500), i % 3 == 0, 0)
+            if i == count // 2:
+                data = b"\x00\xa5" + data[:-1] + bytes([data[-1] ^ 1])
+            os.write(master, data)
+
+    threading.Thread(target=board, daemon=True).start()
+    with os.fdopen(slave, "rb", buffering=0) as stream:
+        n = decode(stream, args.csv, args.window, args.hz, count - 1)
+    os.close(master)
+    if n != count - 1:                           # one frame was corrupted
+        sys.exit("loopback: decoded %d of %d frames" % (n, count - 1))
+    print("loopback: %d frames decoded, 1 corrupt frame skipped" % n,
+          file=sys.stderr)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("source", nargs="?", help="device or file (default stdin)")
+    parser.add_argument("--csv", type=argparse.FileType("w"), default=sys.stdout,
+                        help="CSV output (default stdout)")
+    parser.add_argument("--window", type=int, default=16,
+                        help="frames per rolling report (default 16)")
+    parser.add_argument("--hz", type=float, default=2000000,
+                        help="timebase rate (TIMEBASE_HZ, default 2000000)")
+    parser.add_argument("--loopback", action="store_true",
+                        help="decode synthetic frames sent through a pty")
+    parser.add_argument("--frames", type=int, default=64,
+                        help="frames --loopback sends (default 64)")
+    args = parser.parse_args()
+    if args.loopback:
+        loopback(args)
+    elif args.source:
+        with open(args.source, "rb", buffering=0) as stream:
+            decode(stream, args.csv, args.window, args.hz)
+    else:
+        decode(sys.stdin.buffer, args.csv, args.window, args.hz)
+
+
+if __name__ == "__main__":
+    main()
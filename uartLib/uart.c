@@ -0,0 +1,136 @@
+#include <msp430.h>
+#include "clocksTimer.h"
+#include "timebase.h"
+#include "isr.h"
+#include "uart.h"
+
+/* single-producer (main), single-consumer (TX interrupt) ring */
+static char tx_ring[UART_TX_LEN];
+static volatile unsigned char tx_head, tx_tail;
+
+/* keeps the compiler from reordering the ring's stores around its indices */
+#define MEMORY_BARRIER() __asm__ __volatile__ ("" ::: "memory")
+
+#define UART_BAUD 9600
+
+/* sets the baud rate divisor for the current SMCLK (USCI in reset) */
+static void
+uart_set_divisor()
+{
+  unsigned long smclk = clockSmclkHz();
+  unsigned int br = smclk / UART_BAUD; /* 208.33 at 2 MHz */
+  unsigned int eighths = (smclk * 8 + UART_BAUD / 2) / UART_BAUD;
+  UCA0BR0 = br;
+  UCA0BR1 = br >> 8;
+  UCA0MCTL = (eighths - br * 8) << 1; /* UCBRSx: the fraction in eighths */
+}
+
+/* before a clock profile change: holds the ring and lets the byte
+   being shifted out finish at the old baud rate */
+static void
+uart_clock_changing(ClockListener *listener)
+{
+  IE2 &= ~UCA0TXIE;		/* uart_clock_changed resumes */
+  while (UCA0STAT & UCBUSY)
+    ;
+}
+
+/* after the change: rescales the baud rate, then resumes the ring */
+static void
+uart_clock_changed(ClockListener *listener)
+{
+  UCA0CTL1 |= UCSWRST;
+  uart_set_divisor();
+  UCA0CTL1 &= ~UCSWRST;
+  if (tx_head != tx_tail)
+    IE2 |= UCA0TXIE;		/* resume sending the ring */
+}
+
+static ClockListener uart_clock_listener = {
+  uart_clock_changed, uart_clock_changing
+};
+
+void
+uart_init()
+{
+  UCA0CTL1 = UCSWRST;		/* hold in reset while configuring */
+  P1SEL |= BIT1 | BIT2;		/* P1.1 = RXD, P1.2 = TXD */
+  P1SEL2 |= BIT1 | BIT2;
+  UCA0CTL0 = 0;			/* 8N1 */
+  UCA0CTL1 = UCSSEL_2 | UCSWRST; /* SMCLK */
+  uart_set_divisor();
+  UCA0CTL1 &= ~UCSWRST;
+  clockAddListener(&uart_clock_listener);
+}
+
+int
+uart_write(const void *data, unsigned char len)
+{
+  const char *p = data;
+  unsigned char head = tx_head;
+  unsigned char used = (head - tx_tail) & (UART_TX_LEN - 1);
+  if (len > UART_TX_LEN - 1 - used)
+    return 0;			/* doesn't fit */
+  while (len--) {
+    tx_ring[head] = *p++;
+    head = (head + 1) & (UART_TX_LEN - 1);
+  }
+  MEMORY_BARRIER();
+  tx_head = head;		/* publish */
+  IE2 |= UCA0TXIE;		/* (re)start the interrupt-driven sender */
+  return 1;
+}
+
+void
+uart_putc(char c)
+{
+  while (!uart_write(&c, 1))
+    ;				/* wait for the interrupt to make room */
+}
+
+void
+uart_puts(const char *s)
+{
+  while (*s)
+    uart_putc(*s++);
+}
+
+void
+uart_put_hex(unsigned int v, unsigned char digits)
+{
+  while (digits--) {
+    unsigned char d = (v >> (digits * 4)) & 0xf;
+    uart_putc(d < 10 ? '0' + d : 'a' + d - 10);
+  }
+}
+
+void
+uart_put_dec(unsigned long v)
+{
+  char digits[10];		/* 2^32 has 10 digits */
+  unsigned char n = 0;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  while (n)
+    uart_putc(digits[--n]);
+}
+
+/* transmit buffer empty: send the next queued byte */
+int
+uart_tx_interrupt()
+{
+  unsigned char tail = tx_tail;
+  ISR_TIME_BEGIN();
+  if (tail != tx_head) {
+    UCA0TXBUF = tx_ring[tail];
+    tx_tail = tail = (tail + 1) & (UART_TX_LEN - 1);
+  }
+  if (tail == tx_head)
+    IE2 &= ~UCA0TXIE;		/* drained: uart_write re-enables */
+  ISR_TIME_END();
+  return 0;
+}
+
+ISR_TRAMPOLINE(USCIAB0TX, uart_tx_interrupt, 0);
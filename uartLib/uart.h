@@ -0,0 +1,68 @@
+#ifndef uart_included
+#define uart_included
+
+/** Starts USCI_A0 as a 9600 baud 8N1 UART on P1.1 (RXD) and P1.2
+ *  (TXD), the launchpad's USB serial port.  The baud rate follows
+ *  clock profile changes (clocksTimer.h): sending pauses across each
+ *  switch, which waits for at most one byte.  Call after configureClocks()
+ *  and lcd_init(), which also configures P1.
+ */
+void uart_init();
+
+/** Bytes the transmit ring holds (a power of two).  The USCIAB0TX
+ *  interrupt sends them in the background.
+ */
+#define UART_TX_LEN 32
+
+/** Queues the len bytes at data to be sent, without waiting.
+ *  Needs interrupts enabled to drain.
+ *  \return 1, or 0 if they didn't all fit (nothing is queued)
+ */
+int uart_write(const void *data, unsigned char len);
+
+/** Queues c, waiting for room in the transmit ring */
+void uart_putc(char c);
+
+/** Sends the characters of s */
+void uart_puts(const char *s);
+
+/** Sends v as digits hex digits (most significant first) */
+void uart_put_hex(unsigned int v, unsigned char digits);
+
+/** Sends v in decimal */
+void uart_put_dec(unsigned long v);
+
+/** Queues a binary telemetry frame describing the last frame
+ *  (frameStats, see shapeLib's framestats.h).  Call after
+ *  frameStatsEnd().  Never waits: if the ring is full the frame is
+ *  dropped and counted in the next one.  Decode with telemetry.py.
+ *
+ *  Layout (little-endian, 21 bytes):
+ *
+ *      0  2  sync: 0xa5 0x5a
+ *      2  2  frame number
+ *      4  4  frame time (timebase ticks)
+ *      8  4  busy time (ticks the CPU was awake)
+ *     12  2  pixels written (saturates)
+ *     14  2  SPI bytes sent (saturates)
+ *     16  2  time in timed interrupt handlers (ticks, saturates)
+ *     18  1  switch events
+ *     19  1  telemetry frames dropped since the last one sent
+ *     20  1  checksum: sum of bytes 2..19
+ */
+void telemetry_send();
+
+#define TELEMETRY_LEN 21
+
+/** Sends the PC-sampling histogram (pcsample.h) as text:
+ *
+ *      pcsample base=c000 shift=7 halvings=0 other=12
+ *      <bin address in hex> <count>     (one line per nonzero bin)
+ *      end
+ *
+ *  Sampling is paused while the (slow) dump is sent, so it doesn't
+ *  sample itself.  pcsample.py maps the bins to function names.
+ */
+void uart_pcsample_dump();
+
+#endif // included
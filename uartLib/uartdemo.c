@@ -0,0 +1,42 @@
+#include <msp430.h>
+#include <libTimer.h>
+#include "uart.h"
+
+/* profiles itself: pcsample.py should find slowWork ~3x busier than fastWork */
+
+static volatile unsigned long sink;
+
+void
+slowWork()
+{
+  unsigned int i;
+  for (i = 0; i < 300; i++)
+    sink += (unsigned long)i * i; /* software multiply */
+}
+
+void
+fastWork()
+{
+  unsigned int i;
+  for (i = 0; i < 300; i++)
+    sink++;
+}
+
+int
+main()
+{
+  configureClocks();
+  timebaseInit();
+  uart_init();
+  or_sr(0x8);			/* GIE (enable interrupts) */
+  uart_puts("uartdemo\r\n");
+  pcSampleStart(997);		/* ~2 kHz, prime to avoid aliasing */
+  for (;;) {
+    unsigned long until = timebaseNow() + TIMEBASE_MS(2000);
+    while ((long)(timebaseNow() - until) < 0) {
+      slowWork();
+      fastWork();
+    }
+    uart_pcsample_dump();
+  }
+}